@@ -0,0 +1,215 @@
+/*
+ * Benchmark (no PC) do analisador incremental de requisições HTTP.
+ *
+ * Compara o analisador_http com o método anterior do servidor: procurar
+ * "\r\n\r\n" na cadeia de segmentos, copiar o cabeçalho para a pilha e
+ * descobrir a rota com uma sequência de strstr(). As requisições são
+ * entregues divididas em segmentos, como chegam numa cadeia de pbufs.
+ *
+ * Também confere que o resultado é o mesmo para qualquer ponto de divisão.
+ *
+ * No PC, strstr() da glibc usa instruções vetoriais; o Cortex-M0+ do RP2040
+ * não tem SIMD e a newlib compara byte a byte. Por isso o método anterior é
+ * medido duas vezes: com a strstr() da glibc e com uma versão byte a byte,
+ * mais próxima do custo real no microcontrolador.
+ *
+ * Compilação e uso (na raiz do projeto):
+ *   gcc -O2 -Ilib/Servidor_Bibliotecas ferramentas/bench_analisador_http.c \
+ *       lib/Servidor_Bibliotecas/analisador_http.c -o bench_analisador_http
+ *   ./bench_analisador_http
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "analisador_http.h"
+
+#define ITERACOES 200000
+#define TAM_SEGMENTO 64     // Tamanho dos segmentos simulados da cadeia
+
+// Requisições típicas enviadas pelas páginas do PicoAtmos
+static const char *const REQUISICOES[] = {
+    "GET /dados HTTP/1.1\r\nHost: 192.168.0.10\r\nConnection: keep-alive\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 Safari/537.36\r\n"
+    "Accept: */*\r\nReferer: http://192.168.0.10/\r\nAccept-Encoding: gzip, deflate\r\n"
+    "Accept-Language: pt-BR,pt;q=0.9,en;q=0.8\r\n\r\n",
+    "GET /calibracao HTTP/1.1\r\nHost: 192.168.0.10\r\nConnection: keep-alive\r\n"
+    "Upgrade-Insecure-Requests: 1\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 Safari/537.36\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+    "Accept-Encoding: gzip, deflate\r\nAccept-Language: pt-BR,pt;q=0.9\r\n"
+    "If-None-Match: \"0123456789abcdef\"\r\n\r\n",
+    "GET /set_limits?temp_min=20&temp_max=30&umid_min=40&umid_max=80&press_min=900&press_max=1000 HTTP/1.1\r\n"
+    "Host: 192.168.0.10\r\nAccept: */*\r\nAccept-Encoding: gzip\r\n\r\n",
+};
+#define NUM_REQUISICOES (sizeof(REQUISICOES) / sizeof(REQUISICOES[0]))
+
+// Segmento de uma cadeia, no lugar de struct pbuf
+typedef struct {
+    const char *dados;
+    size_t tamanho;
+} segmento_t;
+
+static size_t dividir(const char *texto, size_t tam_segmento, segmento_t *segmentos) {
+    size_t total = strlen(texto), n = 0;
+    for (size_t i = 0; i < total; i += tam_segmento) {
+        segmentos[n].dados = texto + i;
+        segmentos[n].tamanho = (total - i < tam_segmento) ? total - i : tam_segmento;
+        n++;
+    }
+    return n;
+}
+
+/* ---------- Método Anterior ---------- */
+
+// strstr() simples, equivalente à versão compacta da newlib
+static char *strstr_byte_a_byte(const char *texto, const char *padrao) {
+    for (; *texto; texto++) {
+        const char *a = texto, *b = padrao;
+        while (*b && *a == *b) { a++; b++; }
+        if (!*b) return (char *)texto;
+    }
+    return NULL;
+}
+
+typedef char *(*funcao_busca_t)(const char *, const char *);
+
+// Equivalente a pbuf_memfind: procura o padrão atravessando os segmentos
+static long procurar_na_cadeia(const segmento_t *seg, size_t n, const char *padrao) {
+    size_t tam_padrao = strlen(padrao), casados = 0, pos = 0;
+    for (size_t s = 0; s < n; s++) {
+        for (size_t i = 0; i < seg[s].tamanho; i++, pos++) {
+            casados = (seg[s].dados[i] == padrao[casados]) ? casados + 1
+                    : (seg[s].dados[i] == padrao[0]) ? 1 : 0;
+            if (casados == tam_padrao) return (long)(pos + 1 - tam_padrao);
+        }
+    }
+    return -1;
+}
+
+static int rota_strstr(const segmento_t *seg, size_t n, funcao_busca_t busca) {
+    long fim = procurar_na_cadeia(seg, n, "\r\n\r\n");
+    if (fim < 0) return -1;
+
+    // Copia o cabeçalho para a pilha (pbuf_copy_partial)
+    char requisicao[1025];
+    size_t copiar = (size_t)fim + 2 < 1024 ? (size_t)fim + 2 : 1024, feito = 0;
+    for (size_t s = 0; s < n && feito < copiar; s++) {
+        size_t parte = seg[s].tamanho < copiar - feito ? seg[s].tamanho : copiar - feito;
+        memcpy(requisicao + feito, seg[s].dados, parte);
+        feito += parte;
+    }
+    requisicao[feito] = '\0';
+
+    int fechar = busca(requisicao, "Connection: close") || busca(requisicao, "connection: close") ||
+                 (busca(requisicao, "HTTP/1.0\r\n") && !busca(requisicao, "Connection: keep-alive"));
+    if (busca(requisicao, "GET /dados"))       return 1 + fechar;
+    if (busca(requisicao, "GET /set_limits"))  return 2 + fechar;
+    if (busca(requisicao, "GET /set_offsets")) return 3 + fechar;
+    if (busca(requisicao, "GET /estatisticas")) return 4 + fechar;
+    if (busca(requisicao, "GET /graficos"))    return 5 + fechar;
+    if (busca(requisicao, "GET /estados"))     return 6 + fechar;
+    if (busca(requisicao, "GET /limites"))     return 7 + fechar;
+    if (busca(requisicao, "GET /calibracao"))  return 8 + fechar;
+    return 9 + fechar;
+}
+
+/* ---------- Analisador Incremental ---------- */
+
+static int rota_analisador(const segmento_t *seg, size_t n, requisicao_http_t *req) {
+    analisador_http_iniciar(req);
+    resultado_analise_http_t resultado = ANALISE_HTTP_INCOMPLETA;
+    for (size_t s = 0; s < n && resultado == ANALISE_HTTP_INCOMPLETA; s++) {
+        size_t usados;
+        resultado = analisador_http_consumir(req, (const uint8_t *)seg[s].dados, seg[s].tamanho, &usados);
+    }
+    if (resultado != ANALISE_HTTP_COMPLETA) return -1;
+    return (int)req->caminho[1] + (req->conexao == CONEXAO_HTTP_FECHAR);
+}
+
+/* ---------- Verificação ---------- */
+
+static int comparar(const requisicao_http_t *a, const requisicao_http_t *b) {
+    return a->metodo == b->metodo && strcmp(a->caminho, b->caminho) == 0 &&
+           strcmp(a->query, b->query) == 0 && strcmp(a->if_none_match, b->if_none_match) == 0 &&
+           a->versao_menor == b->versao_menor && a->conexao == b->conexao &&
+           a->aceita_gzip == b->aceita_gzip && a->content_length == b->content_length;
+}
+
+static int verificar_divisoes(void) {
+    int falhas = 0;
+    for (size_t r = 0; r < NUM_REQUISICOES; r++) {
+        segmento_t inteiro[1] = {{REQUISICOES[r], strlen(REQUISICOES[r])}};
+        requisicao_http_t referencia, teste;
+        if (rota_analisador(inteiro, 1, &referencia) < 0) falhas++;
+
+        for (size_t tam = 1; tam <= inteiro[0].tamanho; tam++) {
+            segmento_t segmentos[1024];
+            size_t n = dividir(REQUISICOES[r], tam, segmentos);
+            if (rota_analisador(segmentos, n, &teste) < 0 || !comparar(&referencia, &teste)) {
+                printf("Divergência na requisição %zu com segmentos de %zu bytes\n", r, tam);
+                falhas++;
+            }
+        }
+    }
+    return falhas;
+}
+
+static double agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(void) {
+    int falhas = verificar_divisoes();
+    printf("Verificação de divisões: %s\n", falhas ? "FALHOU" : "ok");
+
+    segmento_t segmentos[NUM_REQUISICOES][64];
+    size_t num_segmentos[NUM_REQUISICOES];
+    size_t bytes = 0;
+    for (size_t r = 0; r < NUM_REQUISICOES; r++) {
+        num_segmentos[r] = dividir(REQUISICOES[r], TAM_SEGMENTO, segmentos[r]);
+        bytes += strlen(REQUISICOES[r]);
+    }
+
+    volatile int acumulador = 0;
+    double inicio = agora_ns();
+    for (int i = 0; i < ITERACOES; i++) {
+        for (size_t r = 0; r < NUM_REQUISICOES; r++) {
+            acumulador += rota_strstr(segmentos[r], num_segmentos[r], strstr);
+        }
+    }
+    double t_strstr = agora_ns() - inicio;
+
+    inicio = agora_ns();
+    for (int i = 0; i < ITERACOES; i++) {
+        for (size_t r = 0; r < NUM_REQUISICOES; r++) {
+            acumulador += rota_strstr(segmentos[r], num_segmentos[r], strstr_byte_a_byte);
+        }
+    }
+    double t_strstr_byte = agora_ns() - inicio;
+
+    requisicao_http_t req;
+    inicio = agora_ns();
+    for (int i = 0; i < ITERACOES; i++) {
+        for (size_t r = 0; r < NUM_REQUISICOES; r++) {
+            acumulador += rota_analisador(segmentos[r], num_segmentos[r], &req);
+        }
+    }
+    double t_analisador = agora_ns() - inicio;
+
+    double total_req = (double)ITERACOES * NUM_REQUISICOES;
+    double total_mb = (double)ITERACOES * bytes / 1e6;
+    printf("%-36s %10s %10s\n", "método", "ns/req", "MB/s");
+    printf("%-36s %10.1f %10.1f\n", "memfind+cópia+strstr (glibc)",
+           t_strstr / total_req, total_mb / (t_strstr / 1e9));
+    printf("%-36s %10.1f %10.1f\n", "memfind+cópia+strstr (byte a byte)",
+           t_strstr_byte / total_req, total_mb / (t_strstr_byte / 1e9));
+    printf("%-36s %10.1f %10.1f\n", "analisador_http",
+           t_analisador / total_req, total_mb / (t_analisador / 1e9));
+    printf("RAM por conexão: %zu bytes de estado (antes: até 1025 bytes de pilha por requisição)\n",
+           sizeof(requisicao_http_t));
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,205 @@
+/*
+ * Testes de referência e benchmark (no PC) da compensação do BMP280.
+ *
+ * Testes: confere o exemplo de cálculo do datasheet (t_fine = 128422,
+ * 25,08 °C e 100653,27 Pa), compara o caminho inteiro com a fórmula em
+ * dupla precisão do datasheet numa varredura de leituras brutas, e confere
+ * que o lote dá o mesmo resultado que amostras compensadas uma a uma.
+ *
+ * Benchmark: tempo por amostra do método anterior do firmware (conversão
+ * de temperatura e de pressão separadas, t_fine calculado duas vezes), de
+ * bmp280_compensate() e do lote, com a temperatura bruta mudando a cada
+ * amostra e repetida em rajadas de 16 (só a pressão muda). No Cortex-M0+ a
+ * diferença entre os caminhos de 32 e 64 bits é bem maior que no PC: lá a
+ * multiplicação e a divisão de 64 bits são rotinas em software.
+ *
+ * Compilação e uso (na raiz do projeto), uma vez para cada caminho da pressão:
+ *   gcc -O2 -Ilib ferramentas/bench_compensacao_bmp280.c \
+ *       lib/bmp280_compensacao.c -o bench_compensacao_bmp280
+ *   gcc -O2 -Ilib -DBMP280_PRESSURE_64BIT=1 ferramentas/bench_compensacao_bmp280.c \
+ *       lib/bmp280_compensacao.c -o bench_compensacao_bmp280_64
+ *   ./bench_compensacao_bmp280 && ./bench_compensacao_bmp280_64
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "bmp280_compensacao.h"
+
+#define ITERACOES 200
+#define AMOSTRAS 4096
+#define RAJADA 16            // Amostras por temperatura bruta no lote em rajada
+
+// Parâmetros e leituras do exemplo do datasheet
+static const struct bmp280_calib_param PARAMS_DATASHEET = {
+    27504, 26435, -1000,
+    36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000,
+};
+#define RAW_T_DATASHEET 519888
+#define RAW_P_DATASHEET 415148
+
+static int falhas = 0;
+
+/* ---------- Referências ---------- */
+
+// Fórmulas em dupla precisão do datasheet (seção 8.1)
+static void compensar_double(int32_t raw_t, int32_t raw_p, const struct bmp280_calib_param *c, double *t, double *p) {
+    double var1 = (raw_t / 16384.0 - c->dig_t1 / 1024.0) * c->dig_t2;
+    double var2 = ((raw_t / 131072.0 - c->dig_t1 / 8192.0) * (raw_t / 131072.0 - c->dig_t1 / 8192.0)) * c->dig_t3;
+    double t_fine = var1 + var2;
+    *t = t_fine / 5120.0;
+
+    var1 = t_fine / 2.0 - 64000.0;
+    var2 = var1 * var1 * c->dig_p6 / 32768.0;
+    var2 = var2 + var1 * c->dig_p5 * 2.0;
+    var2 = var2 / 4.0 + c->dig_p4 * 65536.0;
+    var1 = (c->dig_p3 * var1 * var1 / 524288.0 + c->dig_p2 * var1) / 524288.0;
+    var1 = (1.0 + var1 / 32768.0) * c->dig_p1;
+    double pressao = 1048576.0 - raw_p;
+    pressao = (pressao - var2 / 4096.0) * 6250.0 / var1;
+    var1 = c->dig_p9 * pressao * pressao / 2147483648.0;
+    var2 = pressao * c->dig_p8 / 32768.0;
+    *p = pressao + (var1 + var2 + c->dig_p7) / 16.0;
+}
+
+// Método anterior do firmware: cada conversão calcula t_fine de novo
+static void compensar_anterior(int32_t raw_t, int32_t raw_p, struct bmp280_calib_param *c, int32_t *t, int32_t *p) {
+    *t = bmp280_convert_temp(raw_t, c);
+    *p = bmp280_convert_pressure(raw_p, raw_t, c);
+}
+
+/* ---------- Testes ---------- */
+
+static void conferir(int condicao, const char *descricao) {
+    if (!condicao) {
+        printf("Falhou: %s\n", descricao);
+        falhas++;
+    }
+}
+
+static void testar_datasheet(void) {
+    int32_t t, p;
+    bmp280_compensate(RAW_T_DATASHEET, RAW_P_DATASHEET, &PARAMS_DATASHEET, &t, &p);
+    printf("Datasheet: %d centésimos de °C, %.2f Pa\n", t, p / (double)(1 << BMP280_PRESSURE_FRAC_BITS));
+    conferir(t == 2508, "temperatura do exemplo (25,08 °C)");
+    // O caminho de 32 bits só tem resolução de 1 Pa e erra alguns Pa
+    double erro_p = fabs(p / (double)(1 << BMP280_PRESSURE_FRAC_BITS) - 100653.27);
+    conferir(erro_p < (BMP280_PRESSURE_64BIT ? 0.05 : 4.0), "pressão do exemplo (100653,27 Pa)");
+
+    double td, pd;
+    compensar_double(RAW_T_DATASHEET, RAW_P_DATASHEET, &PARAMS_DATASHEET, &td, &pd);
+    conferir(fabs(td - 25.08) < 0.01 && fabs(pd - 100653.27) < 0.01, "fórmula em dupla precisão");
+
+    // Conversões antigas continuam dando os mesmos valores
+    struct bmp280_calib_param c = PARAMS_DATASHEET;
+    conferir(bmp280_convert_temp(RAW_T_DATASHEET, &c) == t, "bmp280_convert_temp");
+    conferir(bmp280_convert_pressure(RAW_P_DATASHEET, RAW_T_DATASHEET, &c) ==
+             (p + (1 << (BMP280_PRESSURE_FRAC_BITS - 1))) >> BMP280_PRESSURE_FRAC_BITS, "bmp280_convert_pressure");
+}
+
+// Erro do caminho inteiro em relação à dupla precisão, de -40 a 85 °C e de 300 a 1100 hPa
+static void testar_varredura(void) {
+    double pior_t = 0, pior_p = 0;
+    for (int32_t raw_t = 300000; raw_t <= 700000; raw_t += 1997) {
+        for (int32_t raw_p = 200000; raw_p <= 700000; raw_p += 997) {
+            double td, pd;
+            compensar_double(raw_t, raw_p, &PARAMS_DATASHEET, &td, &pd);
+            if (td < -40 || td > 85 || pd < 30000 || pd > 110000) continue;
+            int32_t t, p;
+            bmp280_compensate(raw_t, raw_p, &PARAMS_DATASHEET, &t, &p);
+            double erro_t = fabs(t / 100.0 - td), erro_p = fabs(p / (double)(1 << BMP280_PRESSURE_FRAC_BITS) - pd);
+            if (erro_t > pior_t) pior_t = erro_t;
+            if (erro_p > pior_p) pior_p = erro_p;
+        }
+    }
+    printf("Maior erro contra a dupla precisão: %.3f °C, %.2f Pa\n", pior_t, pior_p);
+    conferir(pior_t <= 0.01, "erro da temperatura");
+    conferir(pior_p <= (BMP280_PRESSURE_64BIT ? 1.0 : 8.0), "erro da pressão");
+}
+
+static void testar_lote(const int32_t *raw_t, const int32_t *raw_p) {
+    static int32_t t[AMOSTRAS], p[AMOSTRAS], t_mesmo[AMOSTRAS], p_mesmo[AMOSTRAS];
+    bmp280_compensate_batch(raw_t, raw_p, AMOSTRAS, &PARAMS_DATASHEET, t, p);
+
+    // Saídas sobre as próprias entradas
+    for (int i = 0; i < AMOSTRAS; i++) {
+        t_mesmo[i] = raw_t[i];
+        p_mesmo[i] = raw_p[i];
+    }
+    bmp280_compensate_batch(t_mesmo, p_mesmo, AMOSTRAS, &PARAMS_DATASHEET, t_mesmo, p_mesmo);
+
+    int diferentes = 0;
+    for (int i = 0; i < AMOSTRAS; i++) {
+        int32_t ti, pi;
+        bmp280_compensate(raw_t[i], raw_p[i], &PARAMS_DATASHEET, &ti, &pi);
+        if (ti != t[i] || pi != p[i] || ti != t_mesmo[i] || pi != p_mesmo[i]) diferentes++;
+    }
+    conferir(diferentes == 0, "lote igual às amostras uma a uma");
+}
+
+/* ---------- Benchmark ---------- */
+
+static double agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(void) {
+    // Leituras próximas das de uma estação: temperatura e pressão variando pouco
+    static int32_t raw_t[AMOSTRAS], raw_p[AMOSTRAS], raw_t_rajada[AMOSTRAS];
+    srand(1);
+    for (int i = 0; i < AMOSTRAS; i++) {
+        raw_t[i] = RAW_T_DATASHEET + (rand() % 2001) - 1000;
+        raw_p[i] = RAW_P_DATASHEET + (rand() % 4001) - 2000;
+        raw_t_rajada[i] = raw_t[i - i % RAJADA];
+    }
+
+    printf("Caminho da pressão: %d bits\n", BMP280_PRESSURE_64BIT ? 64 : 32);
+    testar_datasheet();
+    testar_varredura();
+    testar_lote(raw_t, raw_p);
+    testar_lote(raw_t_rajada, raw_p);
+    printf("Testes de referência: %s\n", falhas ? "FALHOU" : "ok");
+
+    static int32_t t[AMOSTRAS], p[AMOSTRAS];
+    struct bmp280_calib_param c = PARAMS_DATASHEET;
+    volatile uint32_t acumulador = 0;
+
+    double inicio = agora_ns();
+    for (int n = 0; n < ITERACOES; n++) {
+        for (int i = 0; i < AMOSTRAS; i++) compensar_anterior(raw_t[i], raw_p[i], &c, &t[i], &p[i]);
+        acumulador += (uint32_t)p[n % AMOSTRAS];
+    }
+    double t_anterior = agora_ns() - inicio;
+
+    inicio = agora_ns();
+    for (int n = 0; n < ITERACOES; n++) {
+        for (int i = 0; i < AMOSTRAS; i++) bmp280_compensate(raw_t[i], raw_p[i], &c, &t[i], &p[i]);
+        acumulador += (uint32_t)p[n % AMOSTRAS];
+    }
+    double t_unica = agora_ns() - inicio;
+
+    inicio = agora_ns();
+    for (int n = 0; n < ITERACOES; n++) {
+        bmp280_compensate_batch(raw_t, raw_p, AMOSTRAS, &c, t, p);
+        acumulador += (uint32_t)p[n % AMOSTRAS];
+    }
+    double t_lote = agora_ns() - inicio;
+
+    inicio = agora_ns();
+    for (int n = 0; n < ITERACOES; n++) {
+        bmp280_compensate_batch(raw_t_rajada, raw_p, AMOSTRAS, &c, t, p);
+        acumulador += (uint32_t)p[n % AMOSTRAS];
+    }
+    double t_rajada = agora_ns() - inicio;
+
+    double total = (double)ITERACOES * AMOSTRAS;
+    printf("%-36s %10s\n", "método", "ns/amostra");
+    printf("%-36s %10.1f\n", "convert_temp + convert_pressure", t_anterior / total);
+    printf("%-36s %10.1f\n", "bmp280_compensate", t_unica / total);
+    printf("%-36s %10.1f\n", "lote", t_lote / total);
+    printf("%-36s %10.1f\n", "lote, rajadas de 16", t_rajada / total);
+    return falhas ? 1 : 0;
+}
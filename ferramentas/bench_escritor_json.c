@@ -0,0 +1,240 @@
+/*
+ * Testes de referência e benchmark (no PC) do escritor de JSON.
+ *
+ * Testes: compara json_real() com snprintf("%.Nf") para valores de borda
+ * (empates de arredondamento, -0, subnormais, limites de faixa) e para
+ * milhões de floats aleatórios, e compara o JSON de /dados montado pelo
+ * escritor com o snprintf de 15 argumentos usado antes pelo firmware.
+ *
+ * Benchmark: tempo para montar o JSON de /dados com cada método. No PC o
+ * ganho é menor que no RP2040: aqui o printf usa a FPU, lá é soft float.
+ *
+ * Compilação e uso (na raiz do projeto):
+ *   gcc -O2 -Ilib/Servidor_Bibliotecas ferramentas/bench_escritor_json.c \
+ *       lib/Servidor_Bibliotecas/escritor_json.c -o bench_escritor_json
+ *   ./bench_escritor_json
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "escritor_json.h"
+
+#define ITERACOES 1000000
+#define ALEATORIOS 4000000
+
+/* ---------- Documento de /dados ---------- */
+
+typedef struct {
+    float valores[15];
+} amostra_t;
+
+static const char *const CHAVES[15] = {
+    "temp_aht", "temp_bmp", "temp_media", "umidade", "pressao",
+    "temp_min", "temp_max", "umid_min", "umid_max", "press_min", "press_max",
+    "offset_temp_aht", "offset_temp_bmp", "offset_umid", "offset_press",
+};
+
+// Método anterior do firmware (montar_json_dados antes do escritor)
+static int dados_snprintf(char *destino, size_t tamanho, const amostra_t *a) {
+    const float *v = a->valores;
+    return snprintf(destino, tamanho,
+        "{\"temp_aht\":%.2f,\"temp_bmp\":%.2f,\"temp_media\":%.2f,\"umidade\":%.2f,\"pressao\":%.2f,"
+        "\"temp_min\":%.2f,\"temp_max\":%.2f,\"umid_min\":%.2f,\"umid_max\":%.2f,"
+        "\"press_min\":%.2f,\"press_max\":%.2f,"
+        "\"offset_temp_aht\":%.2f,\"offset_temp_bmp\":%.2f,\"offset_umid\":%.2f,\"offset_press\":%.2f}",
+        v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8], v[9], v[10], v[11], v[12], v[13], v[14]);
+}
+
+static int dados_escritor(char *destino, size_t tamanho, const amostra_t *a) {
+    escritor_json_t j;
+    json_iniciar(&j, destino, tamanho);
+    json_abrir_objeto(&j);
+    for (int i = 0; i < 15; i++) json_membro_real(&j, CHAVES[i], a->valores[i], 2);
+    json_fechar_objeto(&j);
+    return (int)json_terminar(&j);
+}
+
+/* ---------- Testes de Referência ---------- */
+
+static int falhas = 0;
+
+static void conferir_real(float valor, int casas) {
+    char esperado[64], obtido[64];
+    snprintf(esperado, sizeof(esperado), "%.*f", casas, valor);
+
+    escritor_json_t j;
+    json_iniciar(&j, obtido, sizeof(obtido));
+    json_real(&j, valor, (uint8_t)casas);
+    json_terminar(&j);
+
+    if (strcmp(esperado, obtido) != 0) {
+        if (falhas++ < 20) {
+            printf("Divergência: %.9g com %d casas: snprintf=\"%s\" escritor=\"%s\"\n",
+                   valor, casas, esperado, obtido);
+        }
+    }
+}
+
+// Valores que o escritor deve formatar igual ao printf (|v| * 10^casas < 2^32)
+static int dentro_da_faixa(float valor, int casas) {
+    static const double ESCALA[] = {1, 10, 100, 1000, 10000};
+    return isfinite(valor) && fabs((double)valor) * ESCALA[casas] < 4294967295.0;
+}
+
+static void testar_bordas(void) {
+    static const float BORDAS[] = {
+        0.0f, -0.0f, 0.005f, -0.005f, 0.125f, 0.375f, 2.5f, 3.5f, 0.015f, 1.005f,
+        0.001f, -0.001f, 0.0049999f, 0.9999f, 99.995f, 1013.25f, 101325.0f,
+        21.875f, -40.0f, 85.0f, 1e-10f, 1.17549435e-38f, 1.4e-45f,
+        42949672.0f, 42949672.95f, 4294967.0f, 429496.7295f, 16777216.0f,
+    };
+    for (size_t i = 0; i < sizeof(BORDAS) / sizeof(BORDAS[0]); i++) {
+        for (int casas = 0; casas <= JSON_MAX_CASAS; casas++) {
+            if (dentro_da_faixa(BORDAS[i], casas)) conferir_real(BORDAS[i], casas);
+        }
+    }
+
+    // Empates exatos em todas as casas: k / 2^n
+    for (int k = -4096; k <= 4096; k++) {
+        for (int n = 1; n <= 12; n++) {
+            float v = ldexpf((float)k, -n);
+            for (int casas = 0; casas <= JSON_MAX_CASAS; casas++) conferir_real(v, casas);
+        }
+    }
+
+    // Fora da faixa e não finitos viram null
+    char saida[16];
+    escritor_json_t j;
+    const float NULOS[] = {NAN, INFINITY, -INFINITY, 1e10f, -5e9f};
+    for (size_t i = 0; i < sizeof(NULOS) / sizeof(NULOS[0]); i++) {
+        json_iniciar(&j, saida, sizeof(saida));
+        json_real(&j, NULOS[i], 2);
+        json_terminar(&j);
+        if (strcmp(saida, "null") != 0) {
+            printf("Esperado null para %g, obtido \"%s\"\n", NULOS[i], saida);
+            falhas++;
+        }
+    }
+}
+
+static uint32_t semente = 12345;
+static uint32_t aleatorio(void) {
+    semente ^= semente << 13;
+    semente ^= semente >> 17;
+    semente ^= semente << 5;
+    return semente;
+}
+
+static void testar_aleatorios(void) {
+    for (int i = 0; i < ALEATORIOS; i++) {
+        // Bits aleatórios cobrem todas as ordens de grandeza; faixas típicas dos sensores também
+        float v;
+        if (i & 1) {
+            uint32_t bits = aleatorio();
+            memcpy(&v, &bits, sizeof(v));
+        } else {
+            v = (float)((int32_t)aleatorio() % 20000000) / 1000.0f;
+        }
+        int casas = (int)(aleatorio() % (JSON_MAX_CASAS + 1));
+        if (dentro_da_faixa(v, casas)) conferir_real(v, casas);
+    }
+}
+
+static void testar_estrutura(void) {
+    char saida[128];
+    escritor_json_t j;
+    json_iniciar(&j, saida, sizeof(saida));
+    json_abrir_objeto(&j);
+    json_membro_natural(&j, "n", 4000000000u);
+    json_chave(&j, "lista");
+    json_abrir_lista(&j);
+    json_inteiro(&j, -2147483647 - 1);
+    json_fixo(&j, -5, 2);
+    json_booleano(&j, true);
+    json_abrir_objeto(&j);
+    json_fechar_objeto(&j);
+    json_fechar_lista(&j);
+    json_chave(&j, "t");
+    json_texto(&j, "a\"b\\c\n");
+    json_fechar_objeto(&j);
+    json_terminar(&j);
+
+    const char *esperado = "{\"n\":4000000000,\"lista\":[-2147483648,-0.05,true,{}],\"t\":\"a\\\"b\\\\c\\u000a\"}";
+    if (strcmp(saida, esperado) != 0) {
+        printf("Estrutura: esperado %s\n           obtido   %s\n", esperado, saida);
+        falhas++;
+    }
+
+    // Buffer pequeno: json_terminar retorna 0 e a saída fica vazia
+    json_iniciar(&j, saida, 8);
+    json_abrir_objeto(&j);
+    json_membro_real(&j, "temperatura", 21.5f, 2);
+    json_fechar_objeto(&j);
+    if (json_terminar(&j) != 0 || saida[0] != '\0') {
+        printf("Estouro de buffer não detectado\n");
+        falhas++;
+    }
+}
+
+static void preencher(amostra_t *a, int i) {
+    a->valores[0] = 21.5f + (float)(i % 100) * 0.037f;
+    a->valores[1] = 22.1f - (float)(i % 50) * 0.011f;
+    a->valores[2] = (a->valores[0] + a->valores[1]) / 2.0f;
+    a->valores[3] = 55.0f + (float)(i % 37) * 0.13f;
+    a->valores[4] = 1013.25f - (float)(i % 71) * 0.07f;
+    const float fixos[] = {20.0f, 30.0f, 40.0f, 80.0f, 900.0f, 1000.0f, -0.3f, 0.15f, 1.25f, -2.0f};
+    memcpy(&a->valores[5], fixos, sizeof(fixos));
+}
+
+static void testar_documento(void) {
+    for (int i = 0; i < 10000; i++) {
+        amostra_t a;
+        preencher(&a, i);
+        char esperado[768], obtido[768];
+        int tam_esperado = dados_snprintf(esperado, sizeof(esperado), &a);
+        int tam_obtido = dados_escritor(obtido, sizeof(obtido), &a);
+        if (tam_esperado != tam_obtido || strcmp(esperado, obtido) != 0) {
+            if (falhas++ < 20) printf("Documento %d difere:\n  %s\n  %s\n", i, esperado, obtido);
+        }
+    }
+}
+
+static double agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(void) {
+    testar_bordas();
+    testar_aleatorios();
+    testar_estrutura();
+    testar_documento();
+    printf("Testes de referência: %s\n", falhas ? "FALHOU" : "ok");
+
+    amostra_t amostras[64];
+    for (int i = 0; i < 64; i++) preencher(&amostras[i], i);
+
+    char saida[768];
+    volatile int acumulador = 0;
+    double inicio = agora_ns();
+    for (int i = 0; i < ITERACOES; i++) {
+        acumulador += dados_snprintf(saida, sizeof(saida), &amostras[i & 63]);
+    }
+    double t_snprintf = agora_ns() - inicio;
+
+    inicio = agora_ns();
+    for (int i = 0; i < ITERACOES; i++) {
+        acumulador += dados_escritor(saida, sizeof(saida), &amostras[i & 63]);
+    }
+    double t_escritor = agora_ns() - inicio;
+
+    printf("%-28s %10s\n", "método", "ns/doc");
+    printf("%-28s %10.1f\n", "snprintf (15 x %.2f)", t_snprintf / ITERACOES);
+    printf("%-28s %10.1f\n", "escritor_json", t_escritor / ITERACOES);
+    printf("Memória: escritor_json_t ocupa %zu bytes; nenhuma alocação\n", sizeof(escritor_json_t));
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,381 @@
+/*
+ * Testes de referência e benchmark das leituras em centésimos inteiros
+ * (lib/centesimos.h) contra o caminho em float usado antes pelo firmware.
+ *
+ * Testes: a conversão inteira do AHT20 contra a fórmula em dupla precisão
+ * em todas as leituras brutas; as saídas de uma coleta (calibração, médias
+ * do BMP280, faixa do intervalo) nos dois caminhos, que diferem no máximo
+ * em um centésimo, e o estado dos alertas, que só pode diferir com uma
+ * leitura a um centésimo de um limite; a formatação de uma casa contra o
+ * printf("%.1f"), igual fora dos empates.
+ *
+ * Benchmark: ciclos por amostra de cada etapa, nos dois caminhos:
+ *   coleta:   conversão do AHT20, calibração e LEITURAS leituras rápidas do
+ *             BMP280 resumidas em mínimo, máximo e média (núcleo 1)
+ *   registro: média das temperaturas, estado dos alertas, históricos e a
+ *             posição do ponto no gráfico (núcleo 0)
+ *   json:     leituras e faixa do intervalo em /dados
+ *   tela:     as cinco linhas da tela de dados (uma casa)
+ * No PC o float tem FPU e a diferença é pequena; no RP2040 (Cortex-M0+, sem
+ * FPU) cada operação em float é uma rotina em software, e é lá que conta.
+ *
+ * Compilação e uso no PC (na raiz do projeto); os ciclos vêm do TSC em x86
+ * (em outros PCs, a tabela sai em nanossegundos):
+ *   gcc -O2 -Ilib -Ilib/Servidor_Bibliotecas ferramentas/bench_ponto_fixo.c \
+ *       lib/centesimos.c lib/Servidor_Bibliotecas/escritor_json.c -lm -o bench_ponto_fixo
+ *   ./bench_ponto_fixo
+ *
+ * No alvo, um executável à parte no CMakeLists.txt (saída pela USB):
+ *   add_executable(bench_ponto_fixo ferramentas/bench_ponto_fixo.c lib/centesimos.c
+ *                  lib/Servidor_Bibliotecas/escritor_json.c)
+ *   target_include_directories(bench_ponto_fixo PRIVATE lib lib/Servidor_Bibliotecas)
+ *   target_link_libraries(bench_ponto_fixo pico_stdlib)
+ *   pico_enable_stdio_usb(bench_ponto_fixo 1)
+ * Lá os ciclos são os do SysTick, contando o clock do processador.
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "centesimos.h"
+#include "fila_amostras.h"           // agregado_t (só as funções inline)
+#include "escritor_json.h"
+
+#if PICO_ON_DEVICE
+#include "pico/stdlib.h"
+#include "hardware/structs/systick.h"
+#define AMOSTRAS 64
+#define ITERACOES 20
+#else
+#define AMOSTRAS 4096
+#define ITERACOES 200
+#endif
+
+#define LEITURAS 20                  // Leituras rápidas do BMP280 por coleta (10 Hz, 2 s)
+
+/* ---------- Contagem de Ciclos ---------- */
+
+#if PICO_ON_DEVICE
+// SysTick de 24 bits, decrescente: cada medida precisa caber em 2^24 ciclos
+static void iniciar_ciclos(void) {
+    systick_hw->rvr = 0x00FFFFFF;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;           // Ligado, clock do processador
+}
+static inline uint32_t ciclos(void) { return 0x00FFFFFF - systick_hw->cvr; }
+#define DIFERENCA(inicio, fim) (((fim) - (inicio)) & 0x00FFFFFF)
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static void iniciar_ciclos(void) {}
+static inline uint64_t ciclos(void) { return __rdtsc(); }
+#define DIFERENCA(inicio, fim) ((fim) - (inicio))
+#else
+#include <time.h>
+// Sem contador de ciclos à mão: a tabela sai em nanossegundos
+static void iniciar_ciclos(void) {}
+static inline uint64_t ciclos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#define DIFERENCA(inicio, fim) ((fim) - (inicio))
+#endif
+
+/* ---------- Entradas ---------- */
+
+// Leituras brutas de uma coleta, como os drivers entregam
+typedef struct {
+    uint32_t aht_umid, aht_temp;         // 20 bits
+    int32_t bmp_temp[LEITURAS];          // Centésimos de °C (bmp280_compensate)
+    int32_t bmp_press[LEITURAS];         // Pa em Q24.8
+} leitura_bruta_t;
+
+static const float LIMITES_REAIS[6] = {20.0f, 30.0f, 40.0f, 80.0f, 900.0f, 1000.0f};
+static const float OFFSETS_REAIS[4] = {0.35f, -0.2f, 1.5f, -0.75f};   // temp_aht, temp_bmp, umid, press (hPa)
+
+/* ---------- Caminho Anterior (float) ---------- */
+
+typedef struct {
+    float minimo, maximo, soma;
+    uint16_t contagem;
+} agregado_real_t;
+
+static inline void incluir_real(agregado_real_t *a, float v) {
+    if (a->contagem == 0 || v < a->minimo) a->minimo = v;
+    if (a->contagem == 0 || v > a->maximo) a->maximo = v;
+    a->soma += v;
+    a->contagem++;
+}
+
+typedef struct {
+    float t_aht, t_bmp, t_med, umid, press;       // Pressão em Pa
+    agregado_real_t agr_t, agr_p;
+    float hist_temp, hist_press, hist_temp_min, hist_press_max;
+    int estado;
+    uint8_t y_pixel;
+} saida_real_t;
+
+static void coletar_real(const leitura_bruta_t *l, saida_real_t *s) {
+    s->umid = (float)l->aht_umid * 100.0 / 1048576.0 + OFFSETS_REAIS[2];
+    s->t_aht = ((float)l->aht_temp * 200.0 / 1048576.0) - 50.0 + OFFSETS_REAIS[0];
+    memset(&s->agr_t, 0, sizeof(s->agr_t));
+    memset(&s->agr_p, 0, sizeof(s->agr_p));
+    for (int k = 0; k < LEITURAS; k++) {
+        float t = l->bmp_temp[k] / 100.0f + OFFSETS_REAIS[1];
+        float p = l->bmp_press[k] / (float)(1 << 8) + OFFSETS_REAIS[3] * 100.0f;
+        incluir_real(&s->agr_t, t);
+        incluir_real(&s->agr_p, p);
+    }
+    s->t_bmp = s->agr_t.soma / s->agr_t.contagem;
+    s->press = s->agr_p.soma / s->agr_p.contagem;
+}
+
+static void registrar_real(saida_real_t *s) {
+    s->t_med = (s->t_aht + s->t_bmp) / 2.0f;
+    float pressao_hpa = s->press / 100.0f;
+    const float *l = LIMITES_REAIS;
+    s->estado = s->t_med > l[1] ? 1 : s->t_med < l[0] ? 2 : s->umid > l[3] ? 3 : s->umid < l[2] ? 4 :
+                pressao_hpa > l[5] ? 5 : pressao_hpa < l[4] ? 6 : 0;
+    s->hist_temp = s->t_med;
+    s->hist_press = s->press / 100.0f;
+    s->hist_temp_min = (s->t_aht + s->agr_t.minimo) / 2.0f;
+    s->hist_press_max = s->agr_p.maximo / 100.0f;
+    float y_min = 15.0f, faixa = 20.0f;
+    s->y_pixel = 52 - (uint8_t)(((s->hist_temp - y_min) / faixa) * 40);
+}
+
+static size_t json_real_amostra(const saida_real_t *s, char *destino, size_t tamanho) {
+    escritor_json_t j;
+    json_iniciar(&j, destino, tamanho);
+    json_abrir_objeto(&j);
+    json_membro_real(&j, "temp_aht", s->t_aht, 2);
+    json_membro_real(&j, "temp_bmp", s->t_bmp, 2);
+    json_membro_real(&j, "temp_media", s->t_med, 2);
+    json_membro_real(&j, "umidade", s->umid, 2);
+    json_membro_real(&j, "pressao", s->press / 100.0f, 2);
+    json_membro_real(&j, "temp_bmp_min", s->agr_t.minimo, 2);
+    json_membro_real(&j, "temp_bmp_max", s->agr_t.maximo, 2);
+    json_membro_real(&j, "pressao_min", s->agr_p.minimo / 100.0f, 2);
+    json_membro_real(&j, "pressao_max", s->agr_p.maximo / 100.0f, 2);
+    json_fechar_objeto(&j);
+    return json_terminar(&j);
+}
+
+static void tela_real(const saida_real_t *s, char linhas[5][32]) {
+    snprintf(linhas[0], 32, "AHT20: %.1fC", s->t_aht);
+    snprintf(linhas[1], 32, "BMP280:%.1fC", s->t_bmp);
+    snprintf(linhas[2], 32, "Media: %.1fC", s->t_med);
+    snprintf(linhas[3], 32, "Umidade:%.1f%%", s->umid);
+    snprintf(linhas[4], 32, "Press:%.1fhPa", s->press / 100.0);
+}
+
+/* ---------- Caminho em Centésimos ---------- */
+
+typedef struct {
+    int32_t t_aht, t_bmp, t_med, umid, press;     // Pressão em Pa
+    agregado_t agr_t, agr_p;
+    int32_t hist_temp, hist_press, hist_temp_min, hist_press_max;
+    int estado;
+    uint8_t y_pixel;
+} saida_fixa_t;
+
+static int32_t LIMITES[6], OFFSETS[4];            // Em centésimos, como em config_atual
+
+static void coletar_fixo(const leitura_bruta_t *l, saida_fixa_t *s) {
+    s->umid = (int32_t)((l->aht_umid * 625u + (1u << 15)) >> 16) + OFFSETS[2];
+    s->t_aht = (int32_t)((l->aht_temp * 625u + (1u << 14)) >> 15) - 5000 + OFFSETS[0];
+    agregado_zerar(&s->agr_t);
+    agregado_zerar(&s->agr_p);
+    for (int k = 0; k < LEITURAS; k++) {
+        agregado_incluir(&s->agr_t, l->bmp_temp[k] + OFFSETS[1]);
+        agregado_incluir(&s->agr_p, ((l->bmp_press[k] + (1 << 7)) >> 8) + OFFSETS[3]);
+    }
+    s->t_bmp = agregado_media(&s->agr_t);
+    s->press = agregado_media(&s->agr_p);
+}
+
+static void registrar_fixo(saida_fixa_t *s) {
+    s->t_med = (s->t_aht + s->t_bmp) / 2;
+    const int32_t *l = LIMITES;
+    s->estado = s->t_med > l[1] ? 1 : s->t_med < l[0] ? 2 : s->umid > l[3] ? 3 : s->umid < l[2] ? 4 :
+                s->press > l[5] ? 5 : s->press < l[4] ? 6 : 0;
+    s->hist_temp = s->t_med;
+    s->hist_press = s->press;
+    s->hist_temp_min = (s->t_aht + s->agr_t.minimo) / 2;
+    s->hist_press_max = s->agr_p.maximo;
+    int32_t y_min = 1500, faixa = 2000, altura = (s->hist_temp - y_min) * 40 / faixa;
+    if (altura < 0) altura = 0;
+    if (altura > 40) altura = 40;
+    s->y_pixel = 52 - (uint8_t)altura;
+}
+
+static size_t json_fixo_amostra(const saida_fixa_t *s, char *destino, size_t tamanho) {
+    escritor_json_t j;
+    json_iniciar(&j, destino, tamanho);
+    json_abrir_objeto(&j);
+    json_membro_fixo(&j, "temp_aht", s->t_aht, 2);
+    json_membro_fixo(&j, "temp_bmp", s->t_bmp, 2);
+    json_membro_fixo(&j, "temp_media", s->t_med, 2);
+    json_membro_fixo(&j, "umidade", s->umid, 2);
+    json_membro_fixo(&j, "pressao", s->press, 2);
+    json_membro_fixo(&j, "temp_bmp_min", s->agr_t.minimo, 2);
+    json_membro_fixo(&j, "temp_bmp_max", s->agr_t.maximo, 2);
+    json_membro_fixo(&j, "pressao_min", s->agr_p.minimo, 2);
+    json_membro_fixo(&j, "pressao_max", s->agr_p.maximo, 2);
+    json_fechar_objeto(&j);
+    return json_terminar(&j);
+}
+
+static void tela_fixa(const saida_fixa_t *s, char linhas[5][32]) {
+    char n[12];
+    centesimos_formatar(n, sizeof(n), s->t_aht, 1);
+    snprintf(linhas[0], 32, "AHT20: %sC", n);
+    centesimos_formatar(n, sizeof(n), s->t_bmp, 1);
+    snprintf(linhas[1], 32, "BMP280:%sC", n);
+    centesimos_formatar(n, sizeof(n), s->t_med, 1);
+    snprintf(linhas[2], 32, "Media: %sC", n);
+    centesimos_formatar(n, sizeof(n), s->umid, 1);
+    snprintf(linhas[3], 32, "Umidade:%s%%", n);
+    centesimos_formatar(n, sizeof(n), s->press, 1);
+    snprintf(linhas[4], 32, "Press:%shPa", n);
+}
+
+/* ---------- Testes ---------- */
+
+static int falhas = 0;
+
+static void conferir(int condicao, const char *descricao) {
+    if (!condicao) {
+        printf("Falhou: %s\n", descricao);
+        falhas++;
+    }
+}
+
+static void testar_aht20(void) {
+    long pior = 0;
+    for (uint32_t raw = 0; raw < (1u << 20); raw++) {
+        long u = (long)((raw * 625u + (1u << 15)) >> 16), t = (long)((raw * 625u + (1u << 14)) >> 15) - 5000;
+        long eu = labs(u - (long)floor(raw * 10000.0 / 1048576.0 + 0.5));
+        long et = labs(t - ((long)floor(raw * 20000.0 / 1048576.0 + 0.5) - 5000));
+        if (eu > pior) pior = eu;
+        if (et > pior) pior = et;
+    }
+    conferir(pior == 0, "AHT20 igual à fórmula em dupla precisão, arredondada");
+}
+
+static int perto(float real, int32_t fixo, int32_t limite) {
+    return labs(lroundf(real * 100.0f) - fixo) <= limite;
+}
+
+static void testar_amostras(const leitura_bruta_t *l, int n) {
+    int divergentes = 0, estados = 0;
+    for (int i = 0; i < n; i++) {
+        saida_real_t r;
+        saida_fixa_t f;
+        coletar_real(&l[i], &r);
+        registrar_real(&r);
+        coletar_fixo(&l[i], &f);
+        registrar_fixo(&f);
+        if (!perto(r.t_aht, f.t_aht, 1) || !perto(r.umid, f.umid, 1) || !perto(r.t_bmp, f.t_bmp, 1) ||
+            !perto(r.t_med, f.t_med, 1) || !perto(r.press / 100.0f, f.press, 1) ||
+            !perto(r.agr_p.maximo / 100.0f, f.agr_p.maximo, 1) || !perto(r.hist_temp_min, f.hist_temp_min, 1)) {
+            divergentes++;
+        }
+        if (r.estado != f.estado) {
+            // Só vale com uma leitura a um centésimo de um limite
+            int borda = 0;
+            for (int k = 0; k < 6; k++) {
+                int32_t v = k < 2 ? f.t_med : k < 4 ? f.umid : f.press;
+                if (labs(v - LIMITES[k]) <= 1) borda = 1;
+            }
+            if (!borda) estados++;
+        }
+    }
+    conferir(divergentes == 0, "coleta em centésimos a no máximo um centésimo do float");
+    conferir(estados == 0, "mesmo estado de alerta");
+}
+
+static void testar_formatacao(void) {
+    int diferentes = 0;
+    for (int32_t v = -5000; v <= 120000; v++) {
+        if (labs(v) % 10 == 5) continue;              // Empates: printf depende do erro do float
+        if (v > -5 && v < 0) continue;                // printf escreve "-0.0"; centesimos_formatar, "0.0"
+        char esperado[16], obtido[16];
+        snprintf(esperado, sizeof(esperado), "%.1f", v / 100.0);
+        centesimos_formatar(obtido, sizeof(obtido), v, 1);
+        if (strcmp(esperado, obtido) != 0) diferentes++;
+    }
+    conferir(diferentes == 0, "formatação com uma casa igual ao printf");
+}
+
+/* ---------- Benchmark ---------- */
+
+static leitura_bruta_t leituras[AMOSTRAS];
+static saida_real_t saidas_reais[AMOSTRAS];
+static saida_fixa_t saidas_fixas[AMOSTRAS];
+
+// Executa 'corpo' para cada amostra, ITERACOES vezes, e guarda o menor total
+#define MEDIR(resultado, corpo) do {                                       \
+        uint64_t melhor = UINT64_MAX;                                      \
+        for (int n = 0; n < ITERACOES; n++) {                              \
+            uint64_t total = 0;                                            \
+            for (int i = 0; i < AMOSTRAS; i++) {                           \
+                uint64_t c0 = ciclos();                                    \
+                corpo;                                                     \
+                total += DIFERENCA(c0, ciclos());                          \
+            }                                                              \
+            if (total < melhor) melhor = total;                            \
+        }                                                                  \
+        (resultado) = (double)melhor / AMOSTRAS;                           \
+    } while (0)
+
+int main(void) {
+#if PICO_ON_DEVICE
+    stdio_init_all();
+    sleep_ms(3000);                  // Tempo para abrir o terminal da USB
+#endif
+    iniciar_ciclos();
+    for (int k = 0; k < 6; k++) LIMITES[k] = centesimos_de_real(LIMITES_REAIS[k]);
+    for (int k = 0; k < 4; k++) OFFSETS[k] = centesimos_de_real(OFFSETS_REAIS[k]);
+
+    // Leituras por toda a faixa dos sensores, cruzando os limites de alerta
+    srand(1);
+    for (int i = 0; i < AMOSTRAS; i++) {
+        leituras[i].aht_umid = (uint32_t)rand() & 0xFFFFF;
+        leituras[i].aht_temp = 250000 + (uint32_t)rand() % 250000;         // ~10 a 50 °C
+        int32_t t = 500 + rand() % 3500, p = 85000 + rand() % 20000;
+        for (int k = 0; k < LEITURAS; k++) {
+            leituras[i].bmp_temp[k] = t + rand() % 21 - 10;
+            leituras[i].bmp_press[k] = (p + rand() % 41 - 20) * 256 + rand() % 256;
+        }
+    }
+
+#if !PICO_ON_DEVICE
+    testar_aht20();
+    testar_formatacao();
+#endif
+    testar_amostras(leituras, AMOSTRAS);
+    printf("Testes de referência: %s\n", falhas ? "FALHOU" : "ok");
+
+    static char json[512];
+    static char linhas[5][32];
+    volatile size_t acumulador = 0;
+    double coleta_real, coleta_fixa, registro_real, registro_fixo, json_real_c, json_fixo_c, tela_real_c, tela_fixa_c;
+
+    MEDIR(coleta_real, coletar_real(&leituras[i], &saidas_reais[i]));
+    MEDIR(coleta_fixa, coletar_fixo(&leituras[i], &saidas_fixas[i]));
+    MEDIR(registro_real, registrar_real(&saidas_reais[i]));
+    MEDIR(registro_fixo, registrar_fixo(&saidas_fixas[i]));
+    MEDIR(json_real_c, acumulador += json_real_amostra(&saidas_reais[i], json, sizeof(json)));
+    MEDIR(json_fixo_c, acumulador += json_fixo_amostra(&saidas_fixas[i], json, sizeof(json)));
+    MEDIR(tela_real_c, (tela_real(&saidas_reais[i], linhas), acumulador += linhas[4][6]));
+    MEDIR(tela_fixa_c, (tela_fixa(&saidas_fixas[i], linhas), acumulador += linhas[4][6]));
+
+    printf("%-10s %12s %12s\n", "ciclos", "float", "centésimos");
+    printf("%-10s %12.0f %12.0f\n", "coleta", coleta_real, coleta_fixa);
+    printf("%-10s %12.0f %12.0f\n", "registro", registro_real, registro_fixo);
+    printf("%-10s %12.0f %12.0f\n", "json", json_real_c, json_fixo_c);
+    printf("%-10s %12.0f %12.0f\n", "tela", tela_real_c, tela_fixa_c);
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""Decodifica a telemetria binária do PicoAtmos (/dados?fmt=bin).
+
+O formato está documentado em lib/Servidor_Bibliotecas/telemetria.h:
+4 bytes de cabeçalho (versão, número de valores, reservado) seguidos de
+valores float32 little-endian. O resultado tem os mesmos campos do JSON.
+
+Uso:
+  decodificar_telemetria.py http://192.168.0.10          # consulta a placa
+  decodificar_telemetria.py --intervalo 2 http://...     # coleta contínua (uma linha JSON por amostra)
+  curl -s 'http://.../dados?fmt=bin' | decodificar_telemetria.py -
+"""
+
+import argparse
+import json
+import struct
+import sys
+import time
+import urllib.request
+
+CAMPOS = (
+    'temp_aht', 'temp_bmp', 'temp_media', 'umidade', 'pressao',
+    'temp_min', 'temp_max', 'umid_min', 'umid_max', 'press_min', 'press_max',
+    'offset_temp_aht', 'offset_temp_bmp', 'offset_umid', 'offset_press',
+    'intervalo.leituras', 'intervalo.temp_bmp_min', 'intervalo.temp_bmp_max',
+    'intervalo.pressao_min', 'intervalo.pressao_max',
+)
+TAM_CABECALHO = 4
+
+
+def decodificar(dados):
+    """Converte os bytes recebidos num dicionário com os campos conhecidos.
+
+    O formato só cresce ao final; valores que este decodificador não
+    conhece são ignorados, e os que a placa não envia ficam de fora.
+    """
+    if len(dados) < TAM_CABECALHO:
+        raise ValueError('telemetria curta demais (%d bytes)' % len(dados))
+    versao, num_valores, _ = struct.unpack_from('<BBH', dados, 0)
+    if versao < 1:
+        raise ValueError('versão de telemetria inválida: %d' % versao)
+    if len(dados) < TAM_CABECALHO + 4 * num_valores:
+        raise ValueError('telemetria truncada: %d valores anunciados em %d bytes' % (num_valores, len(dados)))
+
+    n = min(num_valores, len(CAMPOS))
+    valores = struct.unpack_from('<%df' % n, dados, TAM_CABECALHO)
+    resultado = {}
+    for nome, valor in zip(CAMPOS, valores):
+        # "intervalo.x" vai para o dicionário aninhado, como no JSON
+        grupo, _, campo = nome.partition('.')
+        if campo:
+            resultado.setdefault(grupo, {})[campo] = round(valor, 4)
+        else:
+            resultado[grupo] = round(valor, 4)
+    return resultado
+
+
+def consultar(base):
+    requisicao = urllib.request.Request(base.rstrip('/') + '/dados',
+                                        headers={'Accept': 'application/octet-stream'})
+    with urllib.request.urlopen(requisicao, timeout=5) as resposta:
+        return resposta.read()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('origem', help='URL da placa ou "-" para ler da entrada padrão')
+    parser.add_argument('--intervalo', type=float, default=0,
+                        help='repete a consulta a cada N segundos (0 = uma vez)')
+    args = parser.parse_args()
+
+    if args.origem == '-':
+        print(json.dumps(decodificar(sys.stdin.buffer.read())))
+        return 0
+
+    while True:
+        amostra = decodificar(consultar(args.origem))
+        amostra['instante'] = round(time.time(), 3)
+        print(json.dumps(amostra), flush=True)
+        if args.intervalo <= 0:
+            return 0
+        time.sleep(args.intervalo)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""Gera o arquivo C com as páginas web do PicoAtmos.
+
+Cada página de paginas_web/ passa por três etapas:
+  1. expansão de <!--#include file="..." --> (estilo comum a todas as páginas);
+  2. minificação conservadora de HTML, CSS e JavaScript;
+  3. compressão gzip determinística (mtime = 0), para builds reprodutíveis.
+
+O resultado é um vetor de bytes por página, com tamanho, tamanho original
+e um hash do conteúdo, servido pelo firmware com Content-Encoding: gzip.
+
+Uso:
+  gerar_paginas_web.py --saida paginas_web.c SIMBOLO=arquivo.html [...]
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+RE_INCLUDE = re.compile(r'<!--#include\s+file="([^"]+)"\s*-->')
+RE_COMENTARIO_HTML = re.compile(r'<!--.*?-->', re.S)
+RE_COMENTARIO_CSS = re.compile(r'/\*.*?\*/', re.S)
+RE_BLOCO = re.compile(r'(<style[^>]*>)(.*?)(</style>)|(<script[^>]*>)(.*?)(</script>)', re.S | re.I)
+
+
+def expandir_includes(texto, diretorio, profundidade=0):
+    """Substitui cada diretiva de inclusão pelo conteúdo do arquivo citado."""
+    if profundidade > 8:
+        raise ValueError('inclusões aninhadas demais')
+
+    def incluir(m):
+        caminho = os.path.join(diretorio, m.group(1))
+        with open(caminho, encoding='utf-8') as f:
+            return expandir_includes(f.read(), os.path.dirname(caminho), profundidade + 1)
+
+    return RE_INCLUDE.sub(incluir, texto)
+
+
+def minificar_css(css):
+    css = RE_COMENTARIO_CSS.sub('', css)
+    css = re.sub(r'\s+', ' ', css)
+    css = re.sub(r'\s*([{};:,>])\s*', r'\1', css)
+    css = css.replace(';}', '}')
+    return css.strip()
+
+
+def minificar_js(js):
+    # Só remove comentários de linha inteira e espaços nas bordas das linhas;
+    # as quebras de linha são mantidas para não depender de ponto e vírgula
+    linhas = []
+    for linha in js.split('\n'):
+        linha = linha.strip()
+        if not linha or linha.startswith('//'):
+            continue
+        linhas.append(linha)
+    return '\n'.join(linhas)
+
+
+def minificar_marcacao(html):
+    html = re.sub(r'\s+', ' ', html)
+    html = re.sub(r'>\s+<', '><', html)
+    return html.strip()
+
+
+def minificar_html(html):
+    html = RE_COMENTARIO_HTML.sub('', html)
+    partes = []
+    inicio = 0
+    for m in RE_BLOCO.finditer(html):
+        partes.append(minificar_marcacao(html[inicio:m.start()]))
+        if m.group(1):
+            partes.append(m.group(1) + minificar_css(m.group(2)) + m.group(3))
+        else:
+            partes.append(m.group(4) + minificar_js(m.group(5)) + m.group(6))
+        inicio = m.end()
+    partes.append(minificar_marcacao(html[inicio:]))
+    return ''.join(partes)
+
+
+def vetor_c(dados, indentacao='    ', por_linha=16):
+    linhas = []
+    for i in range(0, len(dados), por_linha):
+        trecho = dados[i:i + por_linha]
+        linhas.append(indentacao + ', '.join('0x%02x' % b for b in trecho) + ',')
+    return '\n'.join(linhas)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--saida', required=True, help='arquivo .c gerado')
+    parser.add_argument('paginas', nargs='+', metavar='SIMBOLO=arquivo.html')
+    args = parser.parse_args()
+
+    blocos = []
+    resumo = []
+    for item in args.paginas:
+        simbolo, caminho = item.split('=', 1)
+        with open(caminho, encoding='utf-8') as f:
+            html = expandir_includes(f.read(), os.path.dirname(caminho))
+        minificado = minificar_html(html).encode('utf-8')
+        comprimido = gzip.compress(minificado, compresslevel=9, mtime=0)
+        hash_conteudo = hashlib.sha256(minificado).hexdigest()[:16]
+
+        blocos.append(
+            '/* %s: %d bytes -> %d minificado -> %d gzip */\n'
+            'static const uint8_t %s_GZ[] = {\n%s\n};\n'
+            'const pagina_web_t %s = {\n'
+            '    .dados = %s_GZ,\n'
+            '    .tamanho = sizeof(%s_GZ),\n'
+            '    .tamanho_original = %d,\n'
+            '    .hash = "%s",\n'
+            '};\n' % (os.path.basename(caminho), len(html.encode('utf-8')), len(minificado),
+                      len(comprimido), simbolo, vetor_c(comprimido), simbolo, simbolo, simbolo,
+                      len(minificado), hash_conteudo))
+        resumo.append('%s: %d -> %d bytes' % (os.path.basename(caminho),
+                                             len(html.encode('utf-8')), len(comprimido)))
+
+    conteudo = ('/* Arquivo gerado por ferramentas/gerar_paginas_web.py - NÃO EDITE */\n'
+                '#include "html.h"\n\n' + '\n'.join(blocos))
+
+    # Só reescreve se mudou, evitando recompilações desnecessárias
+    anterior = None
+    if os.path.exists(args.saida):
+        with open(args.saida, encoding='utf-8') as f:
+            anterior = f.read()
+    if anterior != conteudo:
+        os.makedirs(os.path.dirname(os.path.abspath(args.saida)), exist_ok=True)
+        with open(args.saida, 'w', encoding='utf-8') as f:
+            f.write(conteudo)
+
+    for linha in resumo:
+        print(linha)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
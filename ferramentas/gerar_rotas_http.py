@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""Gera a tabela de rotas do servidor HTTP do PicoAtmos.
+
+Lê rotas_http.def (uma rota por linha: caminho, métodos e função tratadora)
+e procura uma semente para o hash FNV-1a de lib/Servidor_Bibliotecas/rotas_http.h
+que leve cada caminho a uma posição diferente do índice (hash perfeito).
+No firmware, achar a rota custa um hash e uma comparação de texto.
+
+Uso:
+  gerar_rotas_http.py --saida rotas_http.c rotas_http.def
+"""
+
+import argparse
+import os
+import sys
+
+METODOS = ('GET', 'HEAD', 'POST', 'PUT', 'DELETE', 'OPTIONS')
+MAX_SEMENTES = 1 << 20
+
+
+def hash_rota(caminho, semente):
+    """Mesma conta de hash_rota_http() em rotas_http.h."""
+    h = (2166136261 ^ semente) & 0xFFFFFFFF
+    for b in caminho.encode('utf-8'):
+        h ^= b
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h ^ (h >> 16)
+
+
+def ler_rotas(caminho_def):
+    rotas = []
+    with open(caminho_def, encoding='utf-8') as f:
+        for num, linha in enumerate(f, 1):
+            linha = linha.split('#', 1)[0].strip()
+            if not linha:
+                continue
+            campos = linha.split()
+            if len(campos) != 3:
+                raise ValueError('%s:%d: esperado "caminho método tratador"' % (caminho_def, num))
+            caminho, metodos, tratador = campos
+            if not caminho.startswith('/') or len(caminho) >= 64:
+                raise ValueError('%s:%d: caminho inválido: %s' % (caminho_def, num, caminho))
+            # Vários métodos separados por vírgula: "GET,POST"
+            metodos = metodos.split(',')
+            for metodo in metodos:
+                if metodo not in METODOS:
+                    raise ValueError('%s:%d: método desconhecido: %s' % (caminho_def, num, metodo))
+            if any(r[0] == caminho for r in rotas):
+                raise ValueError('%s:%d: caminho repetido: %s' % (caminho_def, num, caminho))
+            rotas.append((caminho, metodos, tratador))
+    if not rotas or len(rotas) >= 0xFF:
+        raise ValueError('%s: número de rotas inválido' % caminho_def)
+    return rotas
+
+
+def procurar_semente(caminhos):
+    """Menor índice (potência de 2) e menor semente sem colisões."""
+    tamanho = 1
+    while tamanho < len(caminhos):
+        tamanho <<= 1
+    while True:
+        for semente in range(MAX_SEMENTES):
+            posicoes = {hash_rota(c, semente) & (tamanho - 1) for c in caminhos}
+            if len(posicoes) == len(caminhos):
+                return tamanho, semente
+        tamanho <<= 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--saida', required=True, help='arquivo .c gerado')
+    parser.add_argument('rotas', help='arquivo de definição das rotas')
+    args = parser.parse_args()
+
+    rotas = ler_rotas(args.rotas)
+    tamanho, semente = procurar_semente([r[0] for r in rotas])
+
+    indice = [0xFF] * tamanho
+    for i, (caminho, _, _) in enumerate(rotas):
+        indice[hash_rota(caminho, semente) & (tamanho - 1)] = i
+
+    largura = max(len(r[0]) for r in rotas) + 3
+    mascaras = [' | '.join('METODO_HTTP_BIT(%s)' % m for m in ms) + ',' for _, ms, _ in rotas]
+    largura_metodos = max(len(m) for m in mascaras)
+    linhas_rotas = '\n'.join(
+        '    {%-*s %-*s %s},' % (largura, '"%s",' % c, largura_metodos, m, t)
+        for (c, _, t), m in zip(rotas, mascaras))
+    prototipos = '\n'.join(
+        'void %s(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req);' % t
+        for t in sorted({r[2] for r in rotas}))
+    linhas_indice = ', '.join('0x%02x' % v for v in indice)
+
+    conteudo = (
+        '/* Arquivo gerado por ferramentas/gerar_rotas_http.py - NÃO EDITE */\n'
+        '#include "rotas_http.h"\n\n'
+        '/* Tratadores (definidos em main.c) */\n'
+        '%s\n\n'
+        'static const rota_http_t ROTAS[] = {\n%s\n};\n\n'
+        '/* %d rotas em %d posições, semente %d */\n'
+        'static const uint8_t INDICE[%d] = {\n    %s\n};\n\n'
+        'static uint32_t ACESSOS[%d];\n\n'
+        'const tabela_rotas_http_t TABELA_ROTAS_HTTP = {\n'
+        '    .rotas = ROTAS,\n'
+        '    .num_rotas = %d,\n'
+        '    .indice = INDICE,\n'
+        '    .mascara = 0x%xu,\n'
+        '    .semente = 0x%08xu,\n'
+        '    .acessos = ACESSOS,\n'
+        '};\n' % (prototipos, linhas_rotas, len(rotas), tamanho, semente, tamanho, linhas_indice,
+                  len(rotas), len(rotas), tamanho - 1, semente))
+
+    # Só reescreve se mudou, evitando recompilações desnecessárias
+    anterior = None
+    if os.path.exists(args.saida):
+        with open(args.saida, encoding='utf-8') as f:
+            anterior = f.read()
+    if anterior != conteudo:
+        os.makedirs(os.path.dirname(os.path.abspath(args.saida)), exist_ok=True)
+        with open(args.saida, 'w', encoding='utf-8') as f:
+            f.write(conteudo)
+
+    print('%d rotas, índice de %d posições, semente %d' % (len(rotas), tamanho, semente))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -1,6 +1,7 @@
 #include "ssd1306.h"
 #include "font.h"
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include "hardware/i2c.h"
 
@@ -15,7 +16,8 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
     
     // Aloca buffer de dados
     ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
-    if (ssd->ram_buffer == NULL) {
+    ssd->tx_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+    if (ssd->ram_buffer == NULL || ssd->tx_buffer == NULL) {
         // Em caso de falha, poderia adicionar tratamento de erro (ex.: log ou loop infinito)
         while (1);
     }
@@ -23,6 +25,8 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
     // Inicializa buffers
     ssd->ram_buffer[0] = 0x40; // Prefixo de dados
     ssd->port_buffer[0] = 0x00; // Prefixo de comando (Co=0, D/C=0)
+    ssd->window_transfer.estado = TRANSACAO_LIVRE;
+    ssd->data_transfer.estado = TRANSACAO_LIVRE;
 }
 
 // Configura os parâmetros iniciais do display
@@ -57,18 +61,40 @@ void ssd1306_config(ssd1306_t *ssd) {
 // Envia um comando para o display via I2C
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
     ssd->port_buffer[1] = command;
-    i2c_write_blocking(ssd->i2c_port, ssd->address, ssd->port_buffer, 2, false);
+    barramento_escrever(ssd->i2c_port, ssd->address, ssd->port_buffer, 2);
 }
 
 // Envia o buffer de dados para o display
+// Os comandos da janela vão numa só transação (prefixo 0x00 seguido dos comandos),
+// e o quadro em outra; as duas saem por DMA enquanto o programa continua
 void ssd1306_send_data(ssd1306_t *ssd) {
-    ssd1306_command(ssd, 0x21); // Define endereço de coluna
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->width - 1);
-    ssd1306_command(ssd, 0x22); // Define endereço de página
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->pages - 1);
-    i2c_write_blocking(ssd->i2c_port, ssd->address, ssd->ram_buffer, ssd->bufsize, false);
+    ssd1306_wait(ssd);
+    memcpy(ssd->tx_buffer, ssd->ram_buffer, ssd->bufsize);
+
+    ssd->window_cmds[0] = 0x00; // Prefixo de comando
+    ssd->window_cmds[1] = 0x21; // Define endereço de coluna
+    ssd->window_cmds[2] = 0;
+    ssd->window_cmds[3] = ssd->width - 1;
+    ssd->window_cmds[4] = 0x22; // Define endereço de página
+    ssd->window_cmds[5] = 0;
+    ssd->window_cmds[6] = ssd->pages - 1;
+    ssd->window_transfer = (transacao_i2c_t){
+        .endereco = ssd->address, .escrita = ssd->window_cmds, .tam_escrita = sizeof(ssd->window_cmds),
+    };
+    ssd->data_transfer = (transacao_i2c_t){
+        .endereco = ssd->address, .escrita = ssd->tx_buffer, .tam_escrita = ssd->bufsize,
+    };
+    barramento_enfileirar(ssd->i2c_port, &ssd->window_transfer);
+    barramento_enfileirar(ssd->i2c_port, &ssd->data_transfer);
+}
+
+// Quadro ainda na fila ou saindo pelo barramento
+bool ssd1306_busy(ssd1306_t *ssd) {
+    return ssd->data_transfer.estado == TRANSACAO_NA_FILA || ssd->data_transfer.estado == TRANSACAO_EM_CURSO;
+}
+
+void ssd1306_wait(ssd1306_t *ssd) {
+    if (ssd1306_busy(ssd)) barramento_aguardar(ssd->i2c_port, &ssd->data_transfer, BARRAMENTO_LIMITE_US(ssd->bufsize));
 }
 
 // Desenha um pixel no buffer
@@ -5,6 +5,9 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "hardware/i2c.h"
+#include "barramento_i2c.h"
+
+#define SSD1306_I2C_FREQ_MAX (400 * 1000)   // Modo rápido (Fast-mode) do I2C
 
 // Estrutura principal do display SSD1306
 typedef struct {
@@ -13,6 +16,10 @@ typedef struct {
     uint16_t bufsize;
     uint8_t *ram_buffer;
     uint8_t port_buffer[2];
+    // Envio assíncrono (DMA): cópia do quadro em envio, para o desenho seguir no ram_buffer
+    uint8_t *tx_buffer;
+    uint8_t window_cmds[7];
+    transacao_i2c_t window_transfer, data_transfer;
 } ssd1306_t;
 
 // Inicialização e configuração
@@ -22,7 +29,10 @@ void ssd1306_config(ssd1306_t *ssd);
 
 // Comunicação I2C
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
+// Copia o quadro e o envia por DMA, sem esperar; se o anterior ainda estiver saindo, espera por ele
 void ssd1306_send_data(ssd1306_t *ssd);
+bool ssd1306_busy(ssd1306_t *ssd);
+void ssd1306_wait(ssd1306_t *ssd);
 
 // Funções de desenho básicas
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
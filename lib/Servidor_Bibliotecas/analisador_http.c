@@ -0,0 +1,429 @@
+#include <string.h>
+#include "analisador_http.h"
+
+/* ---------- Estados da Máquina ---------- */
+enum {
+    ESTADO_METODO,          // Lendo o método ("GET")
+    ESTADO_CAMINHO,         // Lendo o caminho até '?' ou espaço
+    ESTADO_QUERY,           // Lendo a query string até espaço
+    ESTADO_VERSAO,          // Lendo "HTTP/1.x"
+    ESTADO_NOME,            // Lendo o nome de um cabeçalho (ou linha vazia)
+    ESTADO_ESPACO_VALOR,    // Ignorando espaços depois de ':'
+    ESTADO_VALOR,           // Lendo o valor de um cabeçalho
+    ESTADO_FIM_LINHA,       // Linha terminou em '\r'; aguardando '\n'
+    ESTADO_LINHA_VAZIA,     // Linha vazia terminou em '\r'; aguardando o '\n' final
+    ESTADO_FIM,             // Cabeçalho completo
+    ESTADO_ERRO
+};
+
+/* ---------- Cabeçalhos Reconhecidos ---------- */
+// Os nomes ficam em minúsculas; a comparação ignora maiúsculas do que foi recebido
+enum {
+    CAB_CONNECTION,
+    CAB_ACCEPT,
+    CAB_ACCEPT_ENCODING,
+    CAB_IF_NONE_MATCH,
+    CAB_CONTENT_LENGTH,
+    CAB_UPGRADE,
+    CAB_SEC_WEBSOCKET_KEY,
+    CAB_SEC_WEBSOCKET_VERSION,
+    NUM_CABECALHOS,
+    CAB_NENHUM = 0xFF
+};
+
+static const struct {
+    const char *nome;
+    uint8_t tamanho;
+} CABECALHOS[NUM_CABECALHOS] = {
+    [CAB_CONNECTION]            = {"connection", 10},
+    [CAB_ACCEPT]                = {"accept", 6},
+    [CAB_ACCEPT_ENCODING]       = {"accept-encoding", 15},
+    [CAB_IF_NONE_MATCH]         = {"if-none-match", 13},
+    [CAB_CONTENT_LENGTH]        = {"content-length", 14},
+    [CAB_UPGRADE]               = {"upgrade", 7},
+    [CAB_SEC_WEBSOCKET_KEY]     = {"sec-websocket-key", 17},
+    [CAB_SEC_WEBSOCKET_VERSION] = {"sec-websocket-version", 21},
+};
+
+/* ---------- Classes de Bytes ---------- */
+// Bytes que encerram cada tipo de trecho; o miolo dos trechos é copiado em bloco
+#define DELIM_CAMINHO   0x01   // ' ', '?', '\r', '\n'
+#define DELIM_QUERY     0x02   // ' ', '\r', '\n'
+#define DELIM_LINHA     0x04   // '\r', '\n'
+#define DELIM_NOME      0x08   // ':', '\r', '\n'
+
+// Tabela indexada pelo byte: evita uma cadeia de comparações no laço de busca
+static const uint8_t CLASSE_DELIMITADOR[256] = {
+    ['\r'] = DELIM_CAMINHO | DELIM_QUERY | DELIM_LINHA | DELIM_NOME,
+    ['\n'] = DELIM_CAMINHO | DELIM_QUERY | DELIM_LINHA | DELIM_NOME,
+    [' ']  = DELIM_CAMINHO | DELIM_QUERY,
+    ['?']  = DELIM_CAMINHO,
+    [':']  = DELIM_NOME,
+};
+
+/* ---------- Funções Internas ---------- */
+
+static inline char minuscula(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+}
+
+// Procura 'token' em 'texto' sem diferenciar maiúsculas de minúsculas
+static bool contem_token(const char *texto, const char *token) {
+    size_t tam = strlen(token);
+    for (; *texto; texto++) {
+        size_t i = 0;
+        while (i < tam && minuscula(texto[i]) == token[i]) i++;
+        if (i == tam) return true;
+    }
+    return false;
+}
+
+// Peso de 'codificacao' numa lista de Accept-Encoding como "br, gzip;q=0.8, *;q=0"
+// Retorna -1 se ela não aparece, 0 se aparece com q=0 (recusada) e 1 se é aceita
+static int8_t peso_codificacao(const char *lista, const char *codificacao) {
+    size_t tam = strlen(codificacao);
+    const char *p = lista;
+    while (*p) {
+        while (*p == ' ' || *p == ',') p++;
+        const char *nome = p;
+        while (*p && *p != ',' && *p != ';' && *p != ' ') p++;
+        size_t i = 0;
+        while (i < tam && nome + i < p && minuscula(nome[i]) == codificacao[i]) i++;
+        bool encontrada = (i == tam && nome + tam == p);
+
+        // Parâmetros até a próxima vírgula: só "q" interessa, e só se é zero
+        // (qvalue = "0" [ "." 0*3DIGIT ] / "1" [ "." 0*3("0") ])
+        int8_t peso = 1;
+        while (*p && *p != ',') {
+            if (*p++ != ';') continue;
+            while (*p == ' ') p++;
+            if (minuscula(p[0]) != 'q' || p[1] != '=') continue;
+            p += 2;
+            if (*p != '0') continue;
+            p++;
+            if (*p == '.') {
+                p++;
+                while (*p == '0') p++;
+            }
+            peso = (*p >= '1' && *p <= '9') ? 1 : 0;
+        }
+        if (encontrada) return peso;
+    }
+    return -1;
+}
+
+static resultado_analise_http_t falhar(requisicao_http_t *req, uint16_t status) {
+    req->estado = ESTADO_ERRO;
+    req->erro = status;
+    return ANALISE_HTTP_ERRO;
+}
+
+// Converte o texto do método (já terminado em '\0' em req->valor)
+static metodo_http_t identificar_metodo(const char *texto) {
+    if (strcmp(texto, "GET") == 0)     return METODO_HTTP_GET;
+    if (strcmp(texto, "HEAD") == 0)    return METODO_HTTP_HEAD;
+    if (strcmp(texto, "POST") == 0)    return METODO_HTTP_POST;
+    if (strcmp(texto, "PUT") == 0)     return METODO_HTTP_PUT;
+    if (strcmp(texto, "DELETE") == 0)  return METODO_HTTP_DELETE;
+    if (strcmp(texto, "OPTIONS") == 0) return METODO_HTTP_OPTIONS;
+    return METODO_HTTP_DESCONHECIDO;
+}
+
+// Compara o nome lido (req->valor, req->pos bytes) com os cabeçalhos conhecidos
+static uint8_t identificar_cabecalho(const requisicao_http_t *req) {
+    for (uint8_t i = 0; i < NUM_CABECALHOS; i++) {
+        if (CABECALHOS[i].tamanho != req->pos) continue;
+        uint8_t j = 0;
+        while (j < req->pos && minuscula(req->valor[j]) == CABECALHOS[i].nome[j]) j++;
+        if (j == req->pos) return i;
+    }
+    return CAB_NENHUM;
+}
+
+// Content-Length: só dígitos, sem passar de 32 bits (até 10 dígitos)
+// Retorna 0, 400 (vazio ou com outros caracteres) ou 413 (maior que 32 bits)
+static uint16_t ler_content_length(const char *texto, uint32_t *valor) {
+    uint64_t n = 0;
+    const char *c = texto;
+    for (; *c >= '0' && *c <= '9'; c++) {
+        if (c - texto == 10) return 413;
+        n = n * 10 + (uint32_t)(*c - '0');
+    }
+    if (c == texto || *c != '\0') return 400;
+    if (n > UINT32_MAX) return 413;
+    *valor = (uint32_t)n;
+    return 0;
+}
+
+// Interpreta o valor completo de um cabeçalho reconhecido
+// Retorna 0 ou o status HTTP de um valor inaceitável
+static uint16_t aplicar_cabecalho(requisicao_http_t *req) {
+    uint16_t erro = 0;
+    // Remove espaços finais
+    while (req->pos > 0 && req->valor[req->pos - 1] == ' ') req->pos--;
+    req->valor[req->pos] = '\0';
+
+    switch (req->cabecalho) {
+        case CAB_CONNECTION:
+            if (contem_token(req->valor, "close"))           req->conexao = CONEXAO_HTTP_FECHAR;
+            else if (contem_token(req->valor, "keep-alive")) req->conexao = CONEXAO_HTTP_MANTER;
+            req->conexao_upgrade = contem_token(req->valor, "upgrade");
+            break;
+        case CAB_ACCEPT:
+            req->aceita_binario = contem_token(req->valor, "application/octet-stream");
+            break;
+        case CAB_ACCEPT_ENCODING: {
+            // gzip citado vale pelo próprio peso; senão vale o de "*"; fora da lista é recusado
+            int8_t peso = peso_codificacao(req->valor, "gzip");
+            if (peso < 0) peso = peso_codificacao(req->valor, "*");
+            req->aceita_gzip = peso > 0;
+            break;
+        }
+        case CAB_IF_NONE_MATCH:
+            memcpy(req->if_none_match, req->valor, req->pos < HTTP_TAM_ETAG ? req->pos + 1 : HTTP_TAM_ETAG);
+            req->if_none_match[HTTP_TAM_ETAG - 1] = '\0';
+            break;
+        case CAB_CONTENT_LENGTH:
+            // Um tamanho mal lido faria o resto do corpo ser tratado como outra requisição
+            erro = ler_content_length(req->valor, &req->content_length);
+            break;
+        case CAB_UPGRADE:
+            req->upgrade_websocket = contem_token(req->valor, "websocket");
+            break;
+        case CAB_SEC_WEBSOCKET_KEY:
+            memcpy(req->chave_websocket, req->valor, req->pos < HTTP_TAM_CHAVE_WS ? req->pos + 1 : HTTP_TAM_CHAVE_WS);
+            req->chave_websocket[HTTP_TAM_CHAVE_WS - 1] = '\0';
+            break;
+        case CAB_SEC_WEBSOCKET_VERSION: {
+            uint8_t n = 0;
+            for (const char *c = req->valor; *c >= '0' && *c <= '9' && n < 100; c++) n = (uint8_t)(n * 10 + (*c - '0'));
+            req->versao_websocket = n;
+            break;
+        }
+        default:
+            break;
+    }
+    req->cabecalho = CAB_NENHUM;
+    return erro;
+}
+
+// Prepara a leitura da próxima linha de cabeçalho
+static void nova_linha(requisicao_http_t *req) {
+    req->estado = ESTADO_NOME;
+    req->pos = 0;
+    req->cabecalho = CAB_NENHUM;
+}
+
+// Avança a máquina com um único byte (método, versão e delimitadores)
+static resultado_analise_http_t avancar(requisicao_http_t *req, char c) {
+    switch (req->estado) {
+        case ESTADO_METODO:
+            if (c == ' ') {
+                req->valor[req->pos] = '\0';
+                req->metodo = identificar_metodo(req->valor);
+                if (req->metodo == METODO_HTTP_DESCONHECIDO) return falhar(req, 501);
+                req->estado = ESTADO_CAMINHO;
+                req->pos = 0;
+            } else if (c < 'A' || c > 'Z' || req->pos >= 7) {
+                return falhar(req, 400);
+            } else {
+                req->valor[req->pos++] = c;
+            }
+            break;
+
+        case ESTADO_CAMINHO:
+            if (c == '\r' || c == '\n' || req->pos == 0) return falhar(req, 400);
+            req->caminho[req->pos] = '\0';
+            req->estado = (c == '?') ? ESTADO_QUERY : ESTADO_VERSAO;
+            req->pos = 0;
+            break;
+
+        case ESTADO_QUERY:
+            if (c == '\r' || c == '\n') return falhar(req, 400);
+            req->query[req->pos] = '\0';
+            req->estado = ESTADO_VERSAO;
+            req->pos = 0;
+            break;
+
+        case ESTADO_VERSAO:
+            // Espera exatamente "HTTP/1." seguido de um dígito
+            if (c == '\r' || c == '\n') {
+                if (req->pos != 8) return falhar(req, 400);
+                if (c == '\r') {
+                    req->estado = ESTADO_FIM_LINHA;
+                } else {
+                    nova_linha(req);
+                }
+            } else if (req->pos < 7) {
+                if (c != "HTTP/1."[req->pos]) return falhar(req, 505);
+                req->pos++;
+            } else if (req->pos == 7 && c >= '0' && c <= '9') {
+                req->versao_menor = (uint8_t)(c - '0');
+                req->pos++;
+            } else {
+                return falhar(req, 400);
+            }
+            break;
+
+        case ESTADO_NOME:
+            if (c == ':') {
+                req->cabecalho = identificar_cabecalho(req);
+                req->estado = ESTADO_ESPACO_VALOR;
+                req->pos = 0;
+            } else if (req->pos != 0) {
+                return falhar(req, 400);                 // Linha sem ':'
+            } else if (c == '\r') {
+                req->estado = ESTADO_LINHA_VAZIA;
+            } else {
+                req->estado = ESTADO_FIM;                // Linha vazia: fim do cabeçalho
+                return ANALISE_HTTP_COMPLETA;
+            }
+            break;
+
+        case ESTADO_ESPACO_VALOR:
+            if (c == ' ' || c == '\t') break;
+            req->estado = ESTADO_VALOR;
+            if (c != '\r' && c != '\n') {
+                if (req->cabecalho != CAB_NENHUM) req->valor[req->pos++] = c;
+                break;
+            }
+            /* fall through */
+
+        case ESTADO_VALOR:
+            if (req->cabecalho != CAB_NENHUM) {
+                uint16_t erro = aplicar_cabecalho(req);
+                if (erro) return falhar(req, erro);
+            }
+            if (c == '\r') {
+                req->estado = ESTADO_FIM_LINHA;
+            } else {
+                nova_linha(req);
+            }
+            break;
+
+        case ESTADO_FIM_LINHA:
+            if (c != '\n') return falhar(req, 400);
+            nova_linha(req);
+            break;
+
+        case ESTADO_LINHA_VAZIA:
+            if (c != '\n') return falhar(req, 400);
+            req->estado = ESTADO_FIM;
+            return ANALISE_HTTP_COMPLETA;
+
+        case ESTADO_FIM:
+            return ANALISE_HTTP_COMPLETA;
+
+        default:
+            return ANALISE_HTTP_ERRO;
+    }
+    return ANALISE_HTTP_INCOMPLETA;
+}
+
+/* ---------- Funções Públicas ---------- */
+
+void analisador_http_iniciar(requisicao_http_t *req) {
+    memset(req, 0, sizeof(*req));
+    req->estado = ESTADO_METODO;
+    req->cabecalho = CAB_NENHUM;
+    req->aceita_gzip = true;        // Sem Accept-Encoding qualquer codificação é aceitável
+}
+
+resultado_analise_http_t analisador_http_consumir(requisicao_http_t *req, const uint8_t *dados,
+                                                  size_t tamanho, size_t *consumidos) {
+    resultado_analise_http_t resultado = ANALISE_HTTP_INCOMPLETA;
+    size_t i = 0;
+
+    if (req->estado == ESTADO_FIM) {
+        resultado = ANALISE_HTTP_COMPLETA;
+    } else if (req->estado == ESTADO_ERRO) {
+        resultado = ANALISE_HTTP_ERRO;
+    }
+
+    while (resultado == ANALISE_HTTP_INCOMPLETA && i < tamanho) {
+        // O miolo de caminho, query, nomes e valores é localizado de uma vez e
+        // copiado com memcpy (ou pulado, se o cabeçalho não interessa); só os
+        // delimitadores e os tokens curtos passam byte a byte pela máquina
+        uint8_t classe = 0;
+        char *destino = NULL;
+        size_t capacidade = 0;
+        switch (req->estado) {
+            case ESTADO_CAMINHO:
+                classe = DELIM_CAMINHO;
+                destino = req->caminho;
+                capacidade = HTTP_TAM_CAMINHO - 1;
+                break;
+            case ESTADO_QUERY:
+                classe = DELIM_QUERY;
+                destino = req->query;
+                capacidade = HTTP_TAM_QUERY - 1;
+                break;
+            case ESTADO_NOME:
+                classe = DELIM_NOME;
+                destino = req->valor;
+                capacidade = HTTP_TAM_VALOR - 1;
+                break;
+            case ESTADO_VALOR:
+                classe = DELIM_LINHA;
+                if (req->cabecalho != CAB_NENHUM) {
+                    destino = req->valor;
+                    capacidade = HTTP_TAM_VALOR - 1;
+                }
+                break;
+            default:
+                break;
+        }
+
+        size_t j = i;
+        if (classe) {
+            while (j < tamanho && !(CLASSE_DELIMITADOR[dados[j]] & classe)) j++;
+        }
+        size_t avanco = (j > i) ? j - i : 1;
+
+        if (req->total + avanco > HTTP_MAX_CABECALHO) {
+            resultado = falhar(req, 431);
+            break;
+        }
+        req->total += (uint16_t)avanco;
+
+        if (j == i) {
+            resultado = avancar(req, (char)dados[i]);
+        } else if (destino) {
+            size_t copiar = avanco;
+            if (req->pos + copiar > capacidade) {
+                // Caminho e query longos demais são recusados; valores são truncados
+                // e nomes truncados não correspondem a nenhum cabeçalho conhecido
+                if (req->estado == ESTADO_CAMINHO || req->estado == ESTADO_QUERY) {
+                    resultado = falhar(req, 414);
+                    break;
+                }
+                copiar = capacidade - req->pos;
+            }
+            memcpy(destino + req->pos, dados + i, copiar);
+            req->pos = (uint8_t)(req->pos + copiar);
+        }
+        i += avanco;
+    }
+
+    if (consumidos) *consumidos = i;
+    return resultado;
+}
+
+bool http_parametro_query(const char *query, const char *nome, char *valor, size_t tamanho) {
+    size_t tam_nome = strlen(nome);
+    const char *p = query;
+    while (*p) {
+        const char *fim = strchr(p, '&');
+        if (!fim) fim = p + strlen(p);
+
+        if ((size_t)(fim - p) > tam_nome && strncmp(p, nome, tam_nome) == 0 && p[tam_nome] == '=') {
+            size_t n = (size_t)(fim - p) - tam_nome - 1;
+            if (n >= tamanho) n = tamanho - 1;
+            memcpy(valor, p + tam_nome + 1, n);
+            valor[n] = '\0';
+            return true;
+        }
+        p = *fim ? fim + 1 : fim;
+    }
+    return false;
+}
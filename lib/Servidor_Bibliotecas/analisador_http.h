@@ -0,0 +1,88 @@
+#ifndef ANALISADOR_HTTP_H
+#define ANALISADOR_HTTP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ---------- Analisador Incremental de Requisições HTTP ---------- */
+// Máquina de estados que percorre a requisição uma única vez, direto dos
+// segmentos recebidos: pode ser alimentada com cada pbuf de uma cadeia e
+// retoma exatamente de onde parou quando a requisição chega dividida.
+// Apenas os campos usados pelo servidor são extraídos.
+
+/* ---------- Limites dos Campos ---------- */
+#define HTTP_TAM_CAMINHO      64    // Caminho da URL (sem a query string)
+#define HTTP_TAM_QUERY        192   // Query string (sem o '?')
+#define HTTP_TAM_ETAG         40    // Valor de If-None-Match
+#define HTTP_TAM_CHAVE_WS     32    // Valor de Sec-WebSocket-Key (24 caracteres)
+#define HTTP_TAM_VALOR        64    // Valor de cabeçalho em análise
+#define HTTP_MAX_CABECALHO    2048  // Tamanho máximo do cabeçalho inteiro
+
+/* ---------- Métodos Reconhecidos ---------- */
+typedef enum {
+    METODO_HTTP_DESCONHECIDO,
+    METODO_HTTP_GET,
+    METODO_HTTP_HEAD,
+    METODO_HTTP_POST,
+    METODO_HTTP_PUT,
+    METODO_HTTP_DELETE,
+    METODO_HTTP_OPTIONS
+} metodo_http_t;
+
+/* ---------- Resultado da Análise ---------- */
+typedef enum {
+    ANALISE_HTTP_INCOMPLETA,   // Precisa de mais bytes
+    ANALISE_HTTP_COMPLETA,     // Cabeçalho terminou; campos prontos para uso
+    ANALISE_HTTP_ERRO          // Requisição inválida; ver campo 'erro'
+} resultado_analise_http_t;
+
+/* ---------- Valores de Connection ---------- */
+typedef enum {
+    CONEXAO_HTTP_PADRAO,       // Cabeçalho ausente: vale o padrão da versão
+    CONEXAO_HTTP_FECHAR,       // Connection: close
+    CONEXAO_HTTP_MANTER        // Connection: keep-alive
+} conexao_http_t;
+
+/* ---------- Requisição Analisada ---------- */
+typedef struct {
+    // Campos extraídos
+    metodo_http_t metodo;
+    char caminho[HTTP_TAM_CAMINHO];
+    char query[HTTP_TAM_QUERY];
+    char if_none_match[HTTP_TAM_ETAG];
+    uint8_t versao_menor;          // 0 para HTTP/1.0, 1 para HTTP/1.1
+    conexao_http_t conexao;
+    bool aceita_gzip;              // Sem Accept-Encoding, ou com gzip (ou "*") de peso maior que zero
+    bool aceita_binario;           // Accept contém "application/octet-stream"
+    uint32_t content_length;
+    bool conexao_upgrade;          // Connection contém "upgrade"
+    bool upgrade_websocket;        // Upgrade: websocket
+    char chave_websocket[HTTP_TAM_CHAVE_WS];
+    uint8_t versao_websocket;      // Sec-WebSocket-Version
+    uint16_t erro;                 // Status HTTP sugerido quando o resultado é ERRO
+
+    // Estado interno da máquina
+    uint8_t estado;
+    uint8_t pos;                   // Posição no token atual
+    uint8_t cabecalho;             // Cabeçalho conhecido em análise
+    uint16_t total;                // Bytes consumidos do cabeçalho até agora
+    char valor[HTTP_TAM_VALOR];    // Método, nome ou valor de cabeçalho em leitura
+} requisicao_http_t;
+
+/* ---------- API do Analisador ---------- */
+
+// Prepara a estrutura para uma nova requisição
+void analisador_http_iniciar(requisicao_http_t *req);
+
+// Consome até 'tamanho' bytes de 'dados'; para no fim do cabeçalho para que
+// requisições encadeadas (pipelining) não sejam misturadas
+// Em '*consumidos' retorna quantos bytes foram usados
+resultado_analise_http_t analisador_http_consumir(requisicao_http_t *req, const uint8_t *dados,
+                                                  size_t tamanho, size_t *consumidos);
+
+// Copia para 'valor' o parâmetro 'nome' da query string (sem decodificar %XX)
+// Retorna false se o parâmetro não existir; valores longos são truncados
+bool http_parametro_query(const char *query, const char *nome, char *valor, size_t tamanho);
+
+#endif // ANALISADOR_HTTP_H
@@ -0,0 +1,193 @@
+#include <string.h>
+#include "escritor_json.h"
+
+static const uint32_t POTENCIAS_10[JSON_MAX_CASAS + 1] = {1, 10, 100, 1000, 10000};
+
+/* ---------- Funções Internas ---------- */
+
+static void escrever(escritor_json_t *j, const char *texto, size_t tamanho) {
+    // Reserva sempre um byte para o '\0' de json_terminar()
+    if (j->estourou || j->tamanho + tamanho >= j->capacidade) {
+        j->estourou = true;
+        return;
+    }
+    memcpy(j->destino + j->tamanho, texto, tamanho);
+    j->tamanho += tamanho;
+}
+
+static void escrever_caractere(escritor_json_t *j, char c) {
+    escrever(j, &c, 1);
+}
+
+// Separa o item anterior deste, se houver
+static void iniciar_valor(escritor_json_t *j) {
+    if (j->virgula) escrever_caractere(j, ',');
+    j->virgula = true;
+}
+
+// Dígitos decimais de 'valor'; 'minimo' completa com zeros à esquerda
+static void escrever_digitos(escritor_json_t *j, uint32_t valor, uint8_t minimo) {
+    char digitos[10];
+    uint8_t n = 0;
+    do {
+        digitos[sizeof(digitos) - 1 - n++] = (char)('0' + valor % 10);
+        valor /= 10;
+    } while (valor || n < minimo);
+    escrever(j, digitos + sizeof(digitos) - n, n);
+}
+
+// Escreve 'magnitude' / 10^casas com exatamente 'casas' decimais
+static void escrever_fixo(escritor_json_t *j, bool negativo, uint32_t magnitude, uint8_t casas) {
+    if (negativo) escrever_caractere(j, '-');
+    uint32_t escala = POTENCIAS_10[casas];
+    escrever_digitos(j, magnitude / escala, 1);
+    if (casas > 0) {
+        escrever_caractere(j, '.');
+        escrever_digitos(j, magnitude % escala, casas);
+    }
+}
+
+// Converte o float em inteiro escalado por 10^casas sem usar ponto flutuante
+// valor = mantissa * 2^expoente; mantissa (24 bits) * 10^4 (14 bits) cabe em 64 bits,
+// então o produto é exato e o arredondamento reproduz o do printf
+static bool escalar_float(float valor, uint8_t casas, bool *negativo, uint32_t *magnitude) {
+    uint32_t bits;
+    memcpy(&bits, &valor, sizeof(bits));
+    *negativo = (bits >> 31) != 0;
+
+    int32_t expoente = (int32_t)((bits >> 23) & 0xFF);
+    uint64_t mantissa = bits & 0x7FFFFF;
+    if (expoente == 0xFF) return false;           // NaN ou infinito
+    if (expoente == 0) {
+        expoente = 1;                             // Subnormal: sem o 1 implícito
+    } else {
+        mantissa |= 0x800000;
+    }
+    expoente -= 127 + 23;
+
+    uint64_t produto = mantissa * POTENCIAS_10[casas];
+    uint64_t inteiro;
+    if (expoente >= 0) {
+        if (expoente > 25) return false;          // Muito além de 2^32 de qualquer forma
+        inteiro = produto << expoente;
+    } else if (expoente < -40) {
+        inteiro = 0;                              // produto < 2^38: menos de meio
+    } else {
+        uint32_t deslocamento = (uint32_t)-expoente;
+        inteiro = produto >> deslocamento;
+        uint64_t resto = produto & ((1ull << deslocamento) - 1);
+        uint64_t metade = 1ull << (deslocamento - 1);
+        if (resto > metade || (resto == metade && (inteiro & 1))) inteiro++;
+    }
+    if (inteiro > UINT32_MAX) return false;
+    *magnitude = (uint32_t)inteiro;
+    return true;
+}
+
+/* ---------- Funções Públicas ---------- */
+
+void json_iniciar(escritor_json_t *j, char *destino, size_t capacidade) {
+    j->destino = destino;
+    j->capacidade = capacidade;
+    j->tamanho = 0;
+    j->virgula = false;
+    j->estourou = (capacidade == 0);
+}
+
+void json_abrir_objeto(escritor_json_t *j) {
+    iniciar_valor(j);
+    escrever_caractere(j, '{');
+    j->virgula = false;
+}
+
+void json_fechar_objeto(escritor_json_t *j) {
+    escrever_caractere(j, '}');
+    j->virgula = true;
+}
+
+void json_abrir_lista(escritor_json_t *j) {
+    iniciar_valor(j);
+    escrever_caractere(j, '[');
+    j->virgula = false;
+}
+
+void json_fechar_lista(escritor_json_t *j) {
+    escrever_caractere(j, ']');
+    j->virgula = true;
+}
+
+void json_chave(escritor_json_t *j, const char *chave) {
+    json_texto(j, chave);
+    escrever_caractere(j, ':');
+    j->virgula = false;
+}
+
+void json_texto(escritor_json_t *j, const char *texto) {
+    iniciar_valor(j);
+    escrever_caractere(j, '"');
+    const char *inicio = texto;
+    for (; *texto; texto++) {
+        unsigned char c = (unsigned char)*texto;
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        // Copia o trecho comum de uma vez e escapa o caractere especial
+        escrever(j, inicio, (size_t)(texto - inicio));
+        if (c == '"' || c == '\\') {
+            char escape[2] = {'\\', (char)c};
+            escrever(j, escape, 2);
+        } else {
+            static const char HEX[] = "0123456789abcdef";
+            char escape[6] = {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xF]};
+            escrever(j, escape, 6);
+        }
+        inicio = texto + 1;
+    }
+    escrever(j, inicio, (size_t)(texto - inicio));
+    escrever_caractere(j, '"');
+}
+
+void json_inteiro(escritor_json_t *j, int32_t valor) {
+    iniciar_valor(j);
+    if (valor < 0) escrever_caractere(j, '-');
+    escrever_digitos(j, valor < 0 ? 0u - (uint32_t)valor : (uint32_t)valor, 1);
+}
+
+void json_natural(escritor_json_t *j, uint32_t valor) {
+    iniciar_valor(j);
+    escrever_digitos(j, valor, 1);
+}
+
+void json_booleano(escritor_json_t *j, bool valor) {
+    iniciar_valor(j);
+    if (valor) escrever(j, "true", 4);
+    else       escrever(j, "false", 5);
+}
+
+void json_fixo(escritor_json_t *j, int32_t valor, uint8_t casas) {
+    iniciar_valor(j);
+    if (casas > JSON_MAX_CASAS) casas = JSON_MAX_CASAS;
+    escrever_fixo(j, valor < 0, valor < 0 ? 0u - (uint32_t)valor : (uint32_t)valor, casas);
+}
+
+void json_real(escritor_json_t *j, float valor, uint8_t casas) {
+    iniciar_valor(j);
+    if (casas > JSON_MAX_CASAS) casas = JSON_MAX_CASAS;
+
+    bool negativo;
+    uint32_t magnitude;
+    if (!escalar_float(valor, casas, &negativo, &magnitude)) {
+        escrever(j, "null", 4);                   // JSON não representa NaN/infinito
+        return;
+    }
+    escrever_fixo(j, negativo, magnitude, casas);
+}
+
+void json_continuar(escritor_json_t *j, char *destino, size_t capacidade) {
+    bool virgula = j->virgula;
+    json_iniciar(j, destino, capacidade);
+    j->virgula = virgula;
+}
+
+size_t json_terminar(escritor_json_t *j) {
+    if (j->capacidade > 0) j->destino[j->estourou ? 0 : j->tamanho] = '\0';
+    return j->estourou ? 0 : j->tamanho;
+}
@@ -0,0 +1,82 @@
+#ifndef ESCRITOR_JSON_H
+#define ESCRITOR_JSON_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ---------- Escritor de JSON ---------- */
+// Monta JSON direto no buffer de saída, sem alocação e sem printf: números
+// são formatados em ponto fixo só com aritmética inteira (o Cortex-M0+ não
+// tem FPU e o printf de float da newlib é caro). Vírgulas entre itens são
+// inseridas automaticamente.
+//
+// Se o buffer acabar, as chamadas seguintes não escrevem mais nada e
+// json_terminar() retorna 0; não é preciso conferir cada chamada.
+
+#define JSON_MAX_CASAS 4    // Casas decimais aceitas por json_real/json_fixo
+
+typedef struct {
+    char *destino;
+    size_t capacidade;
+    size_t tamanho;          // Bytes escritos até agora
+    bool virgula;            // O próximo item precisa de ',' antes
+    bool estourou;           // Faltou espaço em algum momento
+} escritor_json_t;
+
+/* ---------- API do Escritor ---------- */
+
+// Começa a escrever em 'destino' (até 'capacidade' bytes, incluindo o '\0' final)
+void json_iniciar(escritor_json_t *j, char *destino, size_t capacidade);
+
+void json_abrir_objeto(escritor_json_t *j);
+void json_fechar_objeto(escritor_json_t *j);
+void json_abrir_lista(escritor_json_t *j);
+void json_fechar_lista(escritor_json_t *j);
+
+// Chave de um membro de objeto; o valor vem na chamada seguinte
+void json_chave(escritor_json_t *j, const char *chave);
+
+// Valores
+void json_texto(escritor_json_t *j, const char *texto);
+void json_inteiro(escritor_json_t *j, int32_t valor);
+void json_natural(escritor_json_t *j, uint32_t valor);
+void json_booleano(escritor_json_t *j, bool valor);
+
+// Número em ponto fixo: 'valor' já multiplicado por 10^casas (ex.: 2150, 2 -> 21.50)
+void json_fixo(escritor_json_t *j, int32_t valor, uint8_t casas);
+
+// Float com 'casas' decimais, idêntico a printf("%.<casas>f") para |valor| * 10^casas < 2^32
+// A conversão lê os bits do float e arredonda como o printf (empate vai para o par)
+// Valores fora da faixa, NaN e infinito são escritos como null
+void json_real(escritor_json_t *j, float valor, uint8_t casas);
+
+// Termina a string com '\0'; retorna o tamanho (sem o '\0') ou 0 se faltou espaço
+size_t json_terminar(escritor_json_t *j);
+
+// Continua o mesmo documento num novo buffer (respostas enviadas em partes):
+// o que foi escrito antes não é mais acessado, só se o próximo item leva ','
+void json_continuar(escritor_json_t *j, char *destino, size_t capacidade);
+
+// Bytes ainda livres no buffer (sem contar o '\0' final)
+static inline size_t json_restante(const escritor_json_t *j) {
+    return j->estourou ? 0 : j->capacidade - j->tamanho - 1;
+}
+
+// Atalhos para membros "chave": valor
+static inline void json_membro_real(escritor_json_t *j, const char *chave, float valor, uint8_t casas) {
+    json_chave(j, chave);
+    json_real(j, valor, casas);
+}
+
+static inline void json_membro_fixo(escritor_json_t *j, const char *chave, int32_t valor, uint8_t casas) {
+    json_chave(j, chave);
+    json_fixo(j, valor, casas);
+}
+
+static inline void json_membro_natural(escritor_json_t *j, const char *chave, uint32_t valor) {
+    json_chave(j, chave);
+    json_natural(j, valor);
+}
+
+#endif // ESCRITOR_JSON_H
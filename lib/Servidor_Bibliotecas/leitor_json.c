@@ -0,0 +1,110 @@
+#include <stdlib.h>
+#include <string.h>
+#include "leitor_json.h"
+
+/* ---------- Funções Internas ---------- */
+
+static void pular_espacos(leitor_json_t *l) {
+    while (l->atual < l->fim &&
+           (*l->atual == ' ' || *l->atual == '\t' || *l->atual == '\n' || *l->atual == '\r')) {
+        l->atual++;
+    }
+}
+
+static bool digito(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Avança sobre uma sequência de dígitos; retorna quantos havia
+static size_t pular_digitos(const char **p, const char *fim) {
+    const char *inicio = *p;
+    while (*p < fim && digito(**p)) (*p)++;
+    return (size_t)(*p - inicio);
+}
+
+// Comprimento do número JSON que começa em 'p' (0 se não houver um número válido)
+// Gramática: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+static size_t medir_numero(const char *p, const char *fim) {
+    const char *inicio = p;
+    if (p < fim && *p == '-') p++;
+    if (p < fim && *p == '0') {
+        p++;
+    } else if (pular_digitos(&p, fim) == 0) {
+        return 0;
+    }
+    if (p < fim && *p == '.') {
+        p++;
+        if (pular_digitos(&p, fim) == 0) return 0;
+    }
+    if (p < fim && (*p == 'e' || *p == 'E')) {
+        p++;
+        if (p < fim && (*p == '+' || *p == '-')) p++;
+        if (pular_digitos(&p, fim) == 0) return 0;
+    }
+    return (size_t)(p - inicio);
+}
+
+/* ---------- Funções Públicas ---------- */
+
+bool json_ler_numero(const char *texto, size_t tamanho, float *valor) {
+    if (tamanho == 0 || tamanho >= JSON_TAM_NUMERO || medir_numero(texto, texto + tamanho) != tamanho) {
+        return false;
+    }
+    // strtof precisa do texto terminado em '\0'
+    char numero[JSON_TAM_NUMERO];
+    memcpy(numero, texto, tamanho);
+    numero[tamanho] = '\0';
+    *valor = strtof(numero, NULL);
+    return true;
+}
+
+bool leitor_json_iniciar(leitor_json_t *l, const char *texto, size_t tamanho) {
+    l->atual = texto;
+    l->fim = texto + tamanho;
+    l->primeiro = true;
+    pular_espacos(l);
+    if (l->atual >= l->fim || *l->atual != '{') return false;
+    l->atual++;
+    return true;
+}
+
+resultado_leitor_json_t leitor_json_proximo(leitor_json_t *l, char *chave, size_t tam_chave, float *valor) {
+    pular_espacos(l);
+    if (l->atual >= l->fim) return LEITURA_JSON_ERRO;
+
+    // Fim do objeto: só espaços podem vir depois
+    if (*l->atual == '}') {
+        l->atual++;
+        pular_espacos(l);
+        return (l->atual == l->fim) ? LEITURA_JSON_FIM : LEITURA_JSON_ERRO;
+    }
+    if (!l->primeiro) {
+        if (*l->atual != ',') return LEITURA_JSON_ERRO;
+        l->atual++;
+        pular_espacos(l);
+    }
+    l->primeiro = false;
+
+    // Chave entre aspas, sem escapes nem caracteres de controle
+    if (l->atual >= l->fim || *l->atual != '"') return LEITURA_JSON_ERRO;
+    const char *inicio = ++l->atual;
+    while (l->atual < l->fim && *l->atual != '"') {
+        if (*l->atual == '\\' || (unsigned char)*l->atual < 0x20) return LEITURA_JSON_ERRO;
+        l->atual++;
+    }
+    size_t tamanho = (size_t)(l->atual - inicio);
+    if (l->atual >= l->fim || tamanho >= tam_chave) return LEITURA_JSON_ERRO;
+    memcpy(chave, inicio, tamanho);
+    chave[tamanho] = '\0';
+    l->atual++;
+
+    pular_espacos(l);
+    if (l->atual >= l->fim || *l->atual != ':') return LEITURA_JSON_ERRO;
+    l->atual++;
+    pular_espacos(l);
+
+    size_t tam_numero = medir_numero(l->atual, l->fim);
+    if (!json_ler_numero(l->atual, tam_numero, valor)) return LEITURA_JSON_NAO_NUMERO;
+    l->atual += tam_numero;
+    return LEITURA_JSON_MEMBRO;
+}
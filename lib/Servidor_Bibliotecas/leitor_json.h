@@ -0,0 +1,42 @@
+#ifndef LEITOR_JSON_H
+#define LEITOR_JSON_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ---------- Leitor de JSON ---------- */
+// Percorre um objeto JSON plano ({"chave": número, ...}) direto do buffer
+// recebido, sem alocação: cada chamada entrega a próxima chave e seu valor.
+// Só números são aceitos como valor; objetos, listas, textos, true/false e
+// null são recusados, assim como chaves com escapes. É o que a configuração
+// precisa, e nada mais.
+
+#define JSON_TAM_NUMERO 32   // Maior número aceito, em caracteres
+
+typedef struct {
+    const char *atual;       // Próximo caractere a ler
+    const char *fim;
+    bool primeiro;           // Ainda não leu nenhum membro (sem ',' antes)
+} leitor_json_t;
+
+typedef enum {
+    LEITURA_JSON_MEMBRO,     // 'chave' e 'valor' preenchidos
+    LEITURA_JSON_FIM,        // Objeto terminou em '}' (e nada além de espaços depois)
+    LEITURA_JSON_NAO_NUMERO, // 'chave' preenchida, mas o valor não é um número
+    LEITURA_JSON_ERRO        // Texto não é um objeto plano de números
+} resultado_leitor_json_t;
+
+/* ---------- API do Leitor ---------- */
+
+// Começa a ler 'texto'; retorna false se ele não começar com '{'
+bool leitor_json_iniciar(leitor_json_t *l, const char *texto, size_t tamanho);
+
+// Lê o próximo membro; chaves maiores que 'tam_chave' - 1 são um erro
+resultado_leitor_json_t leitor_json_proximo(leitor_json_t *l, char *chave, size_t tam_chave, float *valor);
+
+// Converte 'texto' (exatamente 'tamanho' caracteres) se for um número JSON válido
+// Recusa o que strtof aceitaria mas JSON não: "inf", "nan", hexadecimal, "+1", ".5", "1."
+bool json_ler_numero(const char *texto, size_t tamanho, float *valor);
+
+#endif // LEITOR_JSON_H
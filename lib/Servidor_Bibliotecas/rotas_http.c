@@ -0,0 +1,13 @@
+#include <string.h>
+#include "rotas_http.h"
+
+uint8_t buscar_rota_http(const tabela_rotas_http_t *tabela, const char *caminho) {
+    uint8_t i = tabela->indice[hash_rota_http(caminho, tabela->semente) & tabela->mascara];
+
+    // O hash só garante que rotas diferentes não colidem: um caminho
+    // desconhecido pode cair numa posição ocupada, por isso confere o texto
+    if (i == ROTA_HTTP_INEXISTENTE || strcmp(tabela->rotas[i].caminho, caminho) != 0) {
+        return ROTA_HTTP_INEXISTENTE;
+    }
+    return i;
+}
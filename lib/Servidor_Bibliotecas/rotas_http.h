@@ -0,0 +1,57 @@
+#ifndef ROTAS_HTTP_H
+#define ROTAS_HTTP_H
+
+#include <stdint.h>
+#include "analisador_http.h"
+
+/* ---------- Tabela de Rotas do Servidor HTTP ---------- */
+// As rotas são declaradas em rotas_http.def (caminho, métodos e função) e
+// compiladas no build por ferramentas/gerar_rotas_http.py numa tabela com
+// hash perfeito: a busca custa um hash e uma comparação, qualquer que seja
+// o número de rotas.
+
+struct tcp_pcb;
+struct estado_http;
+
+// Função que gera a resposta de uma rota
+typedef void (*tratador_rota_http_t)(struct tcp_pcb *tpcb, struct estado_http *hs,
+                                     const requisicao_http_t *req);
+
+// Bit de um método na máscara 'metodos' de rota_http_t (ex.: METODO_HTTP_BIT(GET))
+#define METODO_HTTP_BIT(m) (1u << METODO_HTTP_##m)
+
+typedef struct {
+    const char *caminho;             // Caminho exato ("/dados")
+    uint8_t metodos;                 // Métodos aceitos (máscara de METODO_HTTP_BIT)
+    tratador_rota_http_t tratador;   // Função chamada quando a rota é escolhida
+} rota_http_t;
+
+typedef struct {
+    const rota_http_t *rotas;        // Rotas na ordem de rotas_http.def
+    uint8_t num_rotas;
+    const uint8_t *indice;           // Posição do hash -> rota (0xFF = vazio)
+    uint32_t mascara;                // Tamanho do índice - 1 (potência de 2)
+    uint32_t semente;                // Semente que torna o hash livre de colisões
+    uint32_t *acessos;               // Contador de acessos de cada rota
+} tabela_rotas_http_t;
+
+#define ROTA_HTTP_INEXISTENTE 0xFF
+
+extern const tabela_rotas_http_t TABELA_ROTAS_HTTP;   // Definida no arquivo gerado
+
+/* ---------- API das Rotas ---------- */
+
+// Hash FNV-1a com semente; gerar_rotas_http.py usa exatamente a mesma conta
+static inline uint32_t hash_rota_http(const char *caminho, uint32_t semente) {
+    uint32_t h = 2166136261u ^ semente;
+    while (*caminho) {
+        h ^= (uint8_t)*caminho++;
+        h *= 16777619u;
+    }
+    return h ^ (h >> 16);
+}
+
+// Retorna o índice da rota com este caminho ou ROTA_HTTP_INEXISTENTE
+uint8_t buscar_rota_http(const tabela_rotas_http_t *tabela, const char *caminho);
+
+#endif // ROTAS_HTTP_H
@@ -0,0 +1,26 @@
+#include <string.h>
+#include "telemetria.h"
+
+// A ordem dos campos de telemetria_t é a ordem do formato
+_Static_assert(sizeof(telemetria_t) == 4 * TELEMETRIA_NUM_VALORES, "telemetria_t deve conter só os floats do formato");
+
+int telemetria_codificar(const telemetria_t *amostra, uint8_t *destino) {
+    destino[0] = TELEMETRIA_VERSAO;
+    destino[1] = TELEMETRIA_NUM_VALORES;
+    destino[2] = 0;
+    destino[3] = 0;
+
+    // Bytes montados explicitamente: o formato não depende da ordem do processador
+    float valores[TELEMETRIA_NUM_VALORES];
+    memcpy(valores, amostra, sizeof(valores));
+    for (int i = 0; i < TELEMETRIA_NUM_VALORES; i++) {
+        uint32_t bits;
+        memcpy(&bits, &valores[i], sizeof(bits));
+        uint8_t *v = destino + 4 + 4 * i;
+        v[0] = (uint8_t)bits;
+        v[1] = (uint8_t)(bits >> 8);
+        v[2] = (uint8_t)(bits >> 16);
+        v[3] = (uint8_t)(bits >> 24);
+    }
+    return TELEMETRIA_TAMANHO;
+}
@@ -0,0 +1,45 @@
+#ifndef TELEMETRIA_H
+#define TELEMETRIA_H
+
+#include <stdint.h>
+
+/* ---------- Telemetria Binária ---------- */
+// Representação compacta da amostra servida em /dados quando o cliente pede
+// "Accept: application/octet-stream" ou "?fmt=bin". Os valores são os mesmos
+// do JSON, na mesma ordem, sem formatação de texto no microcontrolador.
+//
+// Formato (versão 1), little-endian, 84 bytes:
+//
+//   byte  0      versão do formato (TELEMETRIA_VERSAO)
+//   byte  1      número de valores que seguem (TELEMETRIA_NUM_VALORES)
+//   bytes 2-3    reservado (zero)
+//   bytes 4-83   20 valores float32 IEEE 754, na ordem de telemetria_t
+//
+// Os valores só crescem ao final: um decodificador lê os que conhece e
+// ignora o resto, usando o byte 1. Os 5 últimos (resumo do intervalo, o
+// objeto "intervalo" do JSON) vieram depois dos 15 primeiros.
+// Decodificadores: paginas_web/tempo_real.js e ferramentas/decodificar_telemetria.py
+
+#define TELEMETRIA_VERSAO        1
+#define TELEMETRIA_NUM_VALORES   20
+#define TELEMETRIA_TAMANHO       (4 + 4 * TELEMETRIA_NUM_VALORES)
+
+/* ---------- Valores da Amostra ---------- */
+typedef struct {
+    float temp_aht, temp_bmp, temp_media;      // °C
+    float umidade;                             // %
+    float pressao;                             // hPa
+    float temp_min, temp_max;                  // Limites de alerta
+    float umid_min, umid_max;
+    float press_min, press_max;
+    float offset_temp_aht, offset_temp_bmp;    // Calibrações
+    float offset_umid, offset_press;
+    float leituras;                            // Leituras do BMP280 no intervalo
+    float temp_bmp_min, temp_bmp_max;          // Faixa dessas leituras
+    float pressao_min, pressao_max;
+} telemetria_t;
+
+// Escreve a amostra em 'destino' (TELEMETRIA_TAMANHO bytes); retorna o tamanho
+int telemetria_codificar(const telemetria_t *amostra, uint8_t *destino);
+
+#endif // TELEMETRIA_H
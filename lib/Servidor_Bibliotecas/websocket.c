@@ -0,0 +1,241 @@
+#include <string.h>
+#include "websocket.h"
+
+/* ---------- Estados do Decodificador ---------- */
+enum {
+    ESTADO_WS_CABECALHO,    // Lendo cabeçalho do quadro (tamanho e máscara)
+    ESTADO_WS_PAYLOAD,      // Lendo e desmascarando o payload
+    ESTADO_WS_ERRO
+};
+
+// GUID fixo do handshake (RFC 6455, seção 1.3)
+static const char GUID_WEBSOCKET[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+/* ---------- SHA-1 ---------- */
+// Usado apenas no handshake; implementação compacta, sem tabelas
+
+static inline uint32_t rotacionar(uint32_t x, int n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+static void sha1_bloco(uint32_t h[5], const uint8_t bloco[64]) {
+    uint32_t w[16];
+    for (int i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)bloco[4 * i] << 24) | ((uint32_t)bloco[4 * i + 1] << 16) |
+               ((uint32_t)bloco[4 * i + 2] << 8) | bloco[4 * i + 3];
+    }
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+        // As 16 palavras são reaproveitadas em janela circular
+        if (i >= 16) {
+            w[i & 15] = rotacionar(w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^ w[i & 15], 1);
+        }
+        uint32_t f, k;
+        if (i < 20)      { f = (b & c) | (~b & d);          k = 0x5A827999; }
+        else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+        else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+        else             { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+
+        uint32_t t = rotacionar(a, 5) + f + e + k + w[i & 15];
+        e = d; d = c; c = rotacionar(b, 30); b = a; a = t;
+    }
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+}
+
+// Calcula o SHA-1 de uma mensagem curta (até 119 bytes: no máximo dois blocos)
+static void sha1(const uint8_t *dados, size_t tamanho, uint8_t resumo[20]) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    uint8_t blocos[128] = {0};
+    size_t num_blocos = (tamanho + 8) / 64 + 1;
+
+    memcpy(blocos, dados, tamanho);
+    blocos[tamanho] = 0x80;
+    uint64_t bits = (uint64_t)tamanho * 8;
+    for (int i = 0; i < 8; i++) {
+        blocos[num_blocos * 64 - 1 - i] = (uint8_t)(bits >> (8 * i));
+    }
+    for (size_t i = 0; i < num_blocos; i++) {
+        sha1_bloco(h, blocos + 64 * i);
+    }
+    for (int i = 0; i < 20; i++) {
+        resumo[i] = (uint8_t)(h[i / 4] >> (24 - 8 * (i % 4)));
+    }
+}
+
+/* ---------- Base64 ---------- */
+
+static void base64(const uint8_t *dados, size_t tamanho, char *saida) {
+    static const char ALFABETO[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t j = 0;
+    for (size_t i = 0; i < tamanho; i += 3) {
+        uint32_t v = (uint32_t)dados[i] << 16;
+        if (i + 1 < tamanho) v |= (uint32_t)dados[i + 1] << 8;
+        if (i + 2 < tamanho) v |= dados[i + 2];
+        saida[j++] = ALFABETO[(v >> 18) & 0x3F];
+        saida[j++] = ALFABETO[(v >> 12) & 0x3F];
+        saida[j++] = (i + 1 < tamanho) ? ALFABETO[(v >> 6) & 0x3F] : '=';
+        saida[j++] = (i + 2 < tamanho) ? ALFABETO[v & 0x3F] : '=';
+    }
+    saida[j] = '\0';
+}
+
+/* ---------- Funções Internas ---------- */
+
+static resultado_ws_t falhar(decodificador_ws_t *ws, uint16_t codigo) {
+    ws->estado = ESTADO_WS_ERRO;
+    ws->codigo = codigo;
+    return WS_ERRO;
+}
+
+// Cabeçalho completo: valida o quadro e prepara a leitura do payload
+static resultado_ws_t iniciar_payload(decodificador_ws_t *ws) {
+    const uint8_t *c = ws->cabecalho;
+    uint32_t tamanho = c[1] & 0x7F;
+    if (tamanho == 126) {
+        tamanho = ((uint32_t)c[2] << 8) | c[3];
+    } else if (tamanho == 127) {
+        // Tamanhos de 64 bits nunca cabem no buffer; só os 32 bits baixos importam
+        if (c[2] | c[3] | c[4] | c[5]) return falhar(ws, WS_FECHAMENTO_GRANDE_DEMAIS);
+        tamanho = ((uint32_t)c[6] << 24) | ((uint32_t)c[7] << 16) | ((uint32_t)c[8] << 8) | c[9];
+    }
+
+    if (ws->opcode >= WS_OPCODE_FECHAR) {
+        // Quadros de controle: curtos, nunca fragmentados
+        if (!ws->fim || tamanho > WS_TAM_CONTROLE) return falhar(ws, WS_FECHAMENTO_PROTOCOLO);
+        if (ws->opcode > WS_OPCODE_PONG) return falhar(ws, WS_FECHAMENTO_PROTOCOLO);
+        ws->tamanho_controle = 0;
+    } else if (ws->opcode == WS_OPCODE_CONTINUACAO) {
+        if (!ws->fragmentada) return falhar(ws, WS_FECHAMENTO_PROTOCOLO);
+    } else if (ws->opcode == WS_OPCODE_TEXTO) {
+        if (ws->fragmentada) return falhar(ws, WS_FECHAMENTO_PROTOCOLO);
+        ws->fragmentada = true;
+        ws->tamanho_mensagem = 0;
+    } else if (ws->opcode == WS_OPCODE_BINARIO) {
+        return falhar(ws, WS_FECHAMENTO_NAO_SUPORTADO);   // Só comandos de texto
+    } else {
+        return falhar(ws, WS_FECHAMENTO_PROTOCOLO);
+    }
+
+    if (ws->opcode < WS_OPCODE_FECHAR && ws->tamanho_mensagem + tamanho > WS_TAM_MENSAGEM) {
+        return falhar(ws, WS_FECHAMENTO_GRANDE_DEMAIS);
+    }
+
+    ws->restante = tamanho;
+    ws->indice_mascara = 0;
+    ws->estado = ESTADO_WS_PAYLOAD;
+    return WS_INCOMPLETO;
+}
+
+// Payload completo: entrega o resultado do quadro e volta a esperar cabeçalho
+static resultado_ws_t terminar_quadro(decodificador_ws_t *ws) {
+    ws->estado = ESTADO_WS_CABECALHO;
+    ws->pos_cabecalho = 0;
+
+    switch (ws->opcode) {
+        case WS_OPCODE_PING:
+            return WS_PING;
+        case WS_OPCODE_PONG:
+            return WS_INCOMPLETO;                            // Resposta a um ping nosso
+        case WS_OPCODE_FECHAR:
+            ws->codigo = (ws->tamanho_controle >= 2)
+                       ? (uint16_t)((ws->controle[0] << 8) | ws->controle[1])
+                       : WS_FECHAMENTO_NORMAL;
+            return WS_FECHAR;
+        default:
+            if (!ws->fim) return WS_INCOMPLETO;              // Aguarda a continuação
+            ws->fragmentada = false;
+            ws->mensagem[ws->tamanho_mensagem] = '\0';
+            return WS_MENSAGEM;
+    }
+}
+
+/* ---------- Funções Públicas ---------- */
+
+void websocket_calcular_aceite(const char *chave, char *aceite) {
+    uint8_t texto[WS_TAM_CHAVE + sizeof(GUID_WEBSOCKET)];
+    size_t tam_chave = strnlen(chave, WS_TAM_CHAVE);
+    memcpy(texto, chave, tam_chave);
+    memcpy(texto + tam_chave, GUID_WEBSOCKET, sizeof(GUID_WEBSOCKET) - 1);
+
+    uint8_t resumo[20];
+    sha1(texto, tam_chave + sizeof(GUID_WEBSOCKET) - 1, resumo);
+    base64(resumo, sizeof(resumo), aceite);
+}
+
+void websocket_iniciar(decodificador_ws_t *ws) {
+    memset(ws, 0, sizeof(*ws));
+    ws->estado = ESTADO_WS_CABECALHO;
+}
+
+resultado_ws_t websocket_consumir(decodificador_ws_t *ws, const uint8_t *dados, size_t tamanho,
+                                  size_t *consumidos) {
+    resultado_ws_t resultado = WS_INCOMPLETO;
+    size_t i = 0;
+
+    if (ws->estado == ESTADO_WS_ERRO) {
+        resultado = WS_ERRO;
+    }
+
+    while (resultado == WS_INCOMPLETO && i < tamanho) {
+        if (ws->estado == ESTADO_WS_CABECALHO) {
+            ws->cabecalho[ws->pos_cabecalho++] = dados[i++];
+
+            if (ws->pos_cabecalho == 2) {
+                const uint8_t *c = ws->cabecalho;
+                if (c[0] & 0x70) { resultado = falhar(ws, WS_FECHAMENTO_PROTOCOLO); break; } // RSV sem extensão
+                if (!(c[1] & 0x80)) { resultado = falhar(ws, WS_FECHAMENTO_PROTOCOLO); break; } // Cliente sempre mascara
+                ws->fim = (c[0] & 0x80) != 0;
+                ws->opcode = c[0] & 0x0F;
+                uint8_t tam7 = c[1] & 0x7F;
+                ws->tam_cabecalho = 2 + (tam7 == 126 ? 2 : tam7 == 127 ? 8 : 0) + 4;
+            }
+            if (ws->pos_cabecalho > 2 && ws->pos_cabecalho == ws->tam_cabecalho) {
+                resultado = iniciar_payload(ws);
+                if (resultado == WS_INCOMPLETO && ws->restante == 0) {
+                    resultado = terminar_quadro(ws);
+                }
+            }
+            continue;
+        }
+
+        // Payload: copia o trecho disponível desfazendo a máscara do cliente
+        const uint8_t *mascara = ws->cabecalho + ws->tam_cabecalho - 4;
+        size_t trecho = tamanho - i;
+        if (trecho > ws->restante) trecho = ws->restante;
+
+        uint8_t *destino = (ws->opcode >= WS_OPCODE_FECHAR)
+                         ? ws->controle + ws->tamanho_controle
+                         : (uint8_t *)ws->mensagem + ws->tamanho_mensagem;
+        for (size_t k = 0; k < trecho; k++) {
+            destino[k] = dados[i + k] ^ mascara[ws->indice_mascara];
+            ws->indice_mascara = (ws->indice_mascara + 1) & 3;
+        }
+        if (ws->opcode >= WS_OPCODE_FECHAR) {
+            ws->tamanho_controle += (uint8_t)trecho;
+        } else {
+            ws->tamanho_mensagem += (uint16_t)trecho;
+        }
+        ws->restante -= (uint32_t)trecho;
+        i += trecho;
+
+        if (ws->restante == 0) {
+            resultado = terminar_quadro(ws);
+        }
+    }
+
+    if (consumidos) *consumidos = i;
+    return resultado;
+}
+
+size_t websocket_cabecalho_quadro(uint8_t *destino, uint8_t opcode, uint16_t tamanho) {
+    destino[0] = 0x80 | (opcode & 0x0F);
+    if (tamanho < 126) {
+        destino[1] = (uint8_t)tamanho;
+        return 2;
+    }
+    destino[1] = 126;
+    destino[2] = (uint8_t)(tamanho >> 8);
+    destino[3] = (uint8_t)tamanho;
+    return 4;
+}
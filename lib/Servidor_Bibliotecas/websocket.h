@@ -0,0 +1,82 @@
+#ifndef WEBSOCKET_H
+#define WEBSOCKET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ---------- WebSocket (RFC 6455) ---------- */
+// Aceite do handshake e decodificação incremental dos quadros enviados pelo
+// cliente. Assim como o analisador HTTP, o decodificador é alimentado com
+// cada segmento recebido e retoma de onde parou.
+
+/* ---------- Limites ---------- */
+#define WS_TAM_MENSAGEM     256   // Maior mensagem de texto aceita (somando fragmentos)
+#define WS_TAM_CONTROLE     125   // Maior payload de um quadro de controle (RFC 6455)
+#define WS_TAM_CHAVE        24    // Sec-WebSocket-Key: 16 bytes em base64
+#define WS_TAM_ACEITE       28    // Sec-WebSocket-Accept: SHA-1 (20 bytes) em base64
+#define WS_TAM_MAX_CABECALHO 4    // Cabeçalho de quadro do servidor (até 65535 bytes)
+
+/* ---------- Opcodes ---------- */
+#define WS_OPCODE_CONTINUACAO  0x0
+#define WS_OPCODE_TEXTO        0x1
+#define WS_OPCODE_BINARIO      0x2
+#define WS_OPCODE_FECHAR       0x8
+#define WS_OPCODE_PING         0x9
+#define WS_OPCODE_PONG         0xA
+
+/* ---------- Códigos de Fechamento ---------- */
+#define WS_FECHAMENTO_NORMAL        1000
+#define WS_FECHAMENTO_PROTOCOLO     1002
+#define WS_FECHAMENTO_NAO_SUPORTADO 1003
+#define WS_FECHAMENTO_GRANDE_DEMAIS 1009
+
+/* ---------- Resultado da Decodificação ---------- */
+typedef enum {
+    WS_INCOMPLETO,     // Precisa de mais bytes
+    WS_MENSAGEM,       // Mensagem de texto completa em 'mensagem'
+    WS_PING,           // Ping recebido; payload em 'controle'
+    WS_FECHAR,         // Cliente pediu o fechamento; código em 'codigo'
+    WS_ERRO            // Violação do protocolo; código de fechamento em 'codigo'
+} resultado_ws_t;
+
+/* ---------- Estado do Decodificador ---------- */
+typedef struct {
+    // Resultado
+    char mensagem[WS_TAM_MENSAGEM + 1];   // Texto da mensagem, terminado em '\0'
+    uint16_t tamanho_mensagem;
+    uint8_t controle[WS_TAM_CONTROLE];    // Payload do último ping
+    uint8_t tamanho_controle;
+    uint16_t codigo;                      // Código de fechamento (recebido ou a enviar)
+
+    // Estado interno
+    uint8_t estado;
+    uint8_t cabecalho[14];                // Cabeçalho do quadro atual
+    uint8_t pos_cabecalho;
+    uint8_t tam_cabecalho;                // Tamanho total esperado do cabeçalho
+    uint8_t opcode;                       // Opcode do quadro atual
+    bool fim;                             // Bit FIN do quadro atual
+    bool fragmentada;                     // Há uma mensagem fragmentada em andamento
+    uint32_t restante;                    // Bytes de payload ainda por ler
+    uint8_t indice_mascara;               // Posição na máscara de 4 bytes
+} decodificador_ws_t;
+
+/* ---------- API do WebSocket ---------- */
+
+// Calcula Sec-WebSocket-Accept a partir de Sec-WebSocket-Key
+// 'aceite' deve ter espaço para WS_TAM_ACEITE + 1 bytes
+void websocket_calcular_aceite(const char *chave, char *aceite);
+
+// Prepara o decodificador para o primeiro quadro da conexão
+void websocket_iniciar(decodificador_ws_t *ws);
+
+// Consome até 'tamanho' bytes; para ao completar uma mensagem, ping ou fechamento
+// Em '*consumidos' retorna quantos bytes foram usados
+resultado_ws_t websocket_consumir(decodificador_ws_t *ws, const uint8_t *dados, size_t tamanho,
+                                  size_t *consumidos);
+
+// Escreve o cabeçalho de um quadro do servidor (sem máscara, FIN = 1)
+// Retorna o tamanho do cabeçalho (2 ou 4 bytes)
+size_t websocket_cabecalho_quadro(uint8_t *destino, uint8_t opcode, uint16_t tamanho);
+
+#endif // WEBSOCKET_H
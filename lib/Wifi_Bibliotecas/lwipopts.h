@@ -27,6 +27,9 @@
 // Alterado de 64 para 32 conforme configuração otimizada
 #define MEMP_NUM_TCP_SEG 32
 #define MEMP_NUM_ARP_QUEUE 10
+// PCBs TCP: os 8 slots do servidor HTTP (MAX_CONEXOES_HTTP em main.c), o PCB de escuta
+// e folga para conexões recusadas com 503 e conexões em TIME_WAIT
+#define MEMP_NUM_TCP_PCB 16
 #define PBUF_POOL_SIZE 32
 
 /* ---------- Protocolos de Rede ---------- */
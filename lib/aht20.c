@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "barramento_i2c.h"
 #include "aht20.h"
 
 /* ---------- Constantes do Sensor AHT20 ---------- */
@@ -15,13 +16,13 @@
 
 bool aht20_init(i2c_inst_t *i2c) {
     uint8_t init_cmd[3] = {AHT20_CMD_INIT, 0x08, 0x00};
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, init_cmd, 3, false);
+    barramento_escrever(i2c, AHT20_I2C_ADDR, init_cmd, 3);
     sleep_ms(50);  // Aguarda o sensor inicializar
 
     // Verifica status até que o sensor esteja pronto
     uint8_t status;
     for (int i = 0; i < 10; i++) {
-        i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false);
+        barramento_ler(i2c, AHT20_I2C_ADDR, NULL, 0, &status, 1);
         if ((status & AHT20_STATUS_CALIBRATED) == AHT20_STATUS_CALIBRATED) {
             return true;  // Sensor calibrado e pronto
         }
@@ -31,56 +32,79 @@ bool aht20_init(i2c_inst_t *i2c) {
     return false;  // Falhou na calibração
 }
 
-bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
+bool aht20_start_measurement(i2c_inst_t *i2c, AHT20_Measurement *m) {
     uint8_t trigger_cmd[3] = {AHT20_CMD_TRIGGER, 0x33, 0x00};
-    uint8_t buffer[6];
 
-    // Envia comando de medição
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, trigger_cmd, 3, false);
-    
-    // Aguarda até o sensor estar pronto
+    // Envia comando de medição; o resultado só fica pronto depois da conversão
+    m->active = barramento_escrever(i2c, AHT20_I2C_ADDR, trigger_cmd, 3) == 3;
+    m->next_check = make_timeout_time_ms(AHT20_MEASUREMENT_MS);
+    m->deadline = make_timeout_time_ms(AHT20_TIMEOUT_MS);
+    return m->active;
+}
+
+AHT20_Status aht20_poll_result(i2c_inst_t *i2c, AHT20_Measurement *m, AHT20_Data *data) {
+    if (!m->active) return AHT20_ERROR;
+    if (!time_reached(m->next_check)) return AHT20_PENDING;
+
+    // Verifica se o sensor ainda está convertendo
     uint8_t status;
-    for (int i = 0; i < 10; i++) {
-        i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false);
-        if (!(status & AHT20_STATUS_BUSY)) {
-            break;
-        }
-        sleep_ms(10);
+    if (barramento_ler(i2c, AHT20_I2C_ADDR, NULL, 0, &status, 1) != 1) {
+        m->active = false;
+        return AHT20_ERROR;
     }
-    
-    // Se ainda estiver ocupado, falha na leitura
     if (status & AHT20_STATUS_BUSY) {
-        return false;
+        if (time_reached(m->deadline)) {
+            m->active = false;
+            return AHT20_ERROR;
+        }
+        m->next_check = make_timeout_time_ms(AHT20_RECHECK_MS);
+        return AHT20_PENDING;
     }
+    m->active = false;
 
     // Lê os 6 bytes de dados
-    if (i2c_read_blocking(i2c, AHT20_I2C_ADDR, buffer, 6, false) != 6) {
-        return false;
+    uint8_t buffer[6];
+    if (barramento_ler(i2c, AHT20_I2C_ADDR, NULL, 0, buffer, 6) != 6) {
+        return AHT20_ERROR;
     }
 
     // Processa os dados de umidade (20 bits)
     uint32_t raw_humidity = ((uint32_t)buffer[1] << 12) | 
                            ((uint32_t)buffer[2] << 4) | 
                            (buffer[3] >> 4);
-    data->humidity = (float)raw_humidity * 100.0 / 1048576.0;
+    // raw * 10000 / 2^20 em centésimos de %, que é raw * 625 / 2^16 (cabe em 32 bits)
+    data->humidity = (int32_t)((raw_humidity * 625u + (1u << 15)) >> 16);
 
     // Processa os dados de temperatura (20 bits)
     uint32_t raw_temp = ((uint32_t)(buffer[3] & 0x0F) << 16) | 
                         ((uint32_t)buffer[4] << 8) | 
                         buffer[5];
-    data->temperature = ((float)raw_temp * 200.0 / 1048576.0) - 50.0;
+    // raw * 20000 / 2^20 - 5000 em centésimos de °C, que é raw * 625 / 2^15 - 5000
+    data->temperature = (int32_t)((raw_temp * 625u + (1u << 14)) >> 15) - 5000;
+
+    return AHT20_READY;
+}
 
-    return true;
+bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
+    AHT20_Measurement m;
+    if (!aht20_start_measurement(i2c, &m)) return false;
+
+    // Versão bloqueante: dorme até cada próxima consulta
+    AHT20_Status status;
+    while ((status = aht20_poll_result(i2c, &m, data)) == AHT20_PENDING) {
+        sleep_until(m.next_check);
+    }
+    return status == AHT20_READY;
 }
 
 void aht20_reset(i2c_inst_t *i2c) {
     uint8_t reset_cmd = AHT20_CMD_RESET;
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, &reset_cmd, 1, false);
+    barramento_escrever(i2c, AHT20_I2C_ADDR, &reset_cmd, 1);
     sleep_ms(20);
     aht20_init(i2c);
 }
 
 bool aht20_check(i2c_inst_t *i2c) {
     uint8_t status;
-    return i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false) == 1;
+    return barramento_ler(i2c, AHT20_I2C_ADDR, NULL, 0, &status, 1) == 1;
 }
@@ -2,31 +2,61 @@
 #define AHT20_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include "pico/time.h"
 #include "hardware/i2c.h"
 
 /* ---------- Configurações do Sensor AHT20 ---------- */
 #define AHT20_I2C_ADDR      0x38
+#define AHT20_I2C_FREQ_MAX  (400 * 1000)   // Modo rápido (Fast-mode) do I2C
 
 /* ---------- Comandos do AHT20 ---------- */
 #define AHT20_CMD_INIT      0xBE
 #define AHT20_CMD_TRIGGER   0xAC
 #define AHT20_CMD_RESET     0xBA
 
+/* ---------- Tempos da Medição ---------- */
+#define AHT20_MEASUREMENT_MS  80   // Conversão típica segundo o datasheet
+#define AHT20_RECHECK_MS      5    // Intervalo entre consultas se ainda estiver ocupado
+#define AHT20_TIMEOUT_MS      150  // Desiste se continuar ocupado depois disso
+
 /* ---------- Estrutura de Dados ---------- */
-// Estrutura para armazenar os valores de temperatura e umidade
+// Estrutura para armazenar os valores de temperatura e umidade, em centésimos
+// (lib/centesimos.h): 2508 = 25,08 °C, 4512 = 45,12 %
 typedef struct {
-    float temperature;
-    float humidity;
+    int32_t temperature;
+    int32_t humidity;
 } AHT20_Data;
 
+// Medição em andamento (aht20_start_measurement / aht20_poll_result)
+typedef struct {
+    absolute_time_t next_check;  // Antes disso nem consulta o sensor
+    absolute_time_t deadline;    // Depois disso, ainda ocupado é erro
+    bool active;
+} AHT20_Measurement;
+
+// Resultado de aht20_poll_result
+typedef enum {
+    AHT20_PENDING,               // Conversão ainda em andamento
+    AHT20_READY,                 // Valores lidos em 'data'
+    AHT20_ERROR                  // Sensor não respondeu ou não terminou a tempo
+} AHT20_Status;
+
 /* ---------- API do Sensor AHT20 ---------- */
 
 // Inicializa o sensor AHT20
 bool aht20_init(i2c_inst_t *i2c);
 
-// Faz leitura de temperatura e umidade do AHT20
+// Faz leitura de temperatura e umidade do AHT20, esperando a conversão (~80 ms)
 bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data);
 
+// Dispara uma conversão e retorna na hora; false se o sensor não respondeu
+bool aht20_start_measurement(i2c_inst_t *i2c, AHT20_Measurement *m);
+
+// Confere, sem esperar, se a conversão terminou; só usa o barramento depois
+// do tempo típico de conversão. Em READY ou ERROR a medição é encerrada
+AHT20_Status aht20_poll_result(i2c_inst_t *i2c, AHT20_Measurement *m, AHT20_Data *data);
+
 // Reseta o sensor AHT20
 void aht20_reset(i2c_inst_t *i2c);
 
@@ -0,0 +1,508 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/sync.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "barramento_i2c.h"
+
+/* ---------- Estado de Cada Barramento ---------- */
+typedef struct {
+    uint8_t endereco;
+    const char *nome;
+    uint frequencia_maxima;
+    prioridade_i2c_t prioridade;
+    uint32_t opcoes;
+    estatisticas_dispositivo_t estatisticas;
+} dispositivo_t;
+
+typedef struct {
+    i2c_inst_t *i2c;
+    bool iniciado;
+    uint frequencia_pedida;               // Limite da placa (barramento_iniciar)
+    uint frequencia;                      // Em uso: a maior aceita por todos os registrados
+
+    dispositivo_t dispositivos[BARRAMENTO_MAX_DISPOSITIVOS];
+    uint8_t num_dispositivos;
+
+    uint canal_tx, canal_rx;
+    dma_channel_config config_tx, config_rx;
+    critical_section_t secao;             // Fila e transação atual (interrupções e os dois núcleos)
+
+    transacao_i2c_t *primeira;            // Fila de espera, na ordem de saída
+    transacao_i2c_t *atual;               // Em curso no controlador
+    transacao_i2c_t *membros;             // Transações reunidas na rajada (atual = &rajada)
+    transacao_i2c_t rajada;
+    uint8_t registro_rajada;
+    uint8_t dados_rajada[BARRAMENTO_RAJADA];
+    uint64_t inicio_atual_us;
+    bool abortada;                        // TX_ABRT recebido; o STOP ainda vem
+    uint32_t fonte_abort;                 // IC_TX_ABRT_SOURCE do abort
+    bool abort_pedido;                    // barramento_aguardar() pediu abort por tempo esgotado
+
+    // Comandos do controlador (dado + bits CMD/RESTART/STOP), em dois blocos alternados
+    uint16_t comandos[2][BARRAMENTO_BLOCO];
+    uint16_t tam_bloco[2];
+    uint8_t enviando;                     // Bloco que o DMA está lendo
+    uint32_t montados;                    // Comandos da transação atual já montados
+
+    estatisticas_barramento_t estatisticas;
+} barramento_t;
+
+static barramento_t barramentos[BARRAMENTO_NUM];
+
+/* ---------- Funções Internas ---------- */
+
+static barramento_t *obter(i2c_inst_t *i2c) {
+    barramento_t *b = &barramentos[i2c_hw_index(i2c)];
+    return b->iniciado ? b : NULL;
+}
+
+static int8_t procurar_dispositivo(const barramento_t *b, uint8_t endereco) {
+    for (int i = 0; i < b->num_dispositivos; i++) {
+        if (b->dispositivos[i].endereco == endereco) return (int8_t)i;
+    }
+    return -1;
+}
+
+// Se 'a' deve sair antes de 'c': prioridade maior, ou a mesma com prazo mais próximo
+static bool vem_antes(const transacao_i2c_t *a, const transacao_i2c_t *c) {
+    if (a->prioridade_efetiva != c->prioridade_efetiva) return a->prioridade_efetiva > c->prioridade_efetiva;
+    if (a->prazo_us == 0) return false;
+    return c->prazo_us == 0 || a->prazo_us < c->prazo_us;
+}
+
+// Leitura de registro (um byte com o número do registro, depois os dados) de dispositivo com auto-incremento
+static bool leitura_de_registro(const barramento_t *b, const transacao_i2c_t *t) {
+    return t->dispositivo >= 0 && (b->dispositivos[t->dispositivo].opcoes & DISPOSITIVO_AUTO_INCREMENTO) &&
+           t->tam_escrita == 1 && t->tam_leitura > 0;
+}
+
+static transacao_i2c_t *retirar_primeira(barramento_t *b) {
+    transacao_i2c_t *t = b->primeira;
+    b->primeira = t->proxima;
+    b->estatisticas.fila--;
+    t->proxima = NULL;
+    t->estado = TRANSACAO_EM_CURSO;
+    return t;
+}
+
+// Comando de 16 bits para o i-ésimo byte da transação
+static uint16_t comando(const transacao_i2c_t *t, uint32_t i) {
+    uint16_t c;
+    if (i < t->tam_escrita) {
+        c = t->escrita[i];
+    } else {
+        c = I2C_IC_DATA_CMD_CMD_BITS;                                     // Leitura
+        if (i == t->tam_escrita && t->tam_escrita > 0) c |= I2C_IC_DATA_CMD_RESTART_BITS;
+    }
+    if (i == (uint32_t)t->tam_escrita + t->tam_leitura - 1) c |= I2C_IC_DATA_CMD_STOP_BITS;
+    return c;
+}
+
+// Monta o próximo trecho da transação atual no bloco indicado (tamanho 0 se acabou)
+static void montar_bloco(barramento_t *b, uint8_t bloco) {
+    const transacao_i2c_t *t = b->atual;
+    uint32_t total = (uint32_t)t->tam_escrita + t->tam_leitura;
+    uint16_t n = 0;
+    while (n < BARRAMENTO_BLOCO && b->montados < total) {
+        b->comandos[bloco][n++] = comando(t, b->montados++);
+    }
+    b->tam_bloco[bloco] = n;
+}
+
+// Junta à transação as leituras que continuam a partir do último registro lido por ela
+// Retorna true se juntou alguma; os membros ficam encadeados por 'proxima'
+static bool reunir_rajada(barramento_t *b, transacao_i2c_t *t) {
+    if (!leitura_de_registro(b, t)) return false;
+
+    transacao_i2c_t *ultimo = t;
+    uint32_t total = t->tam_leitura;
+    for (transacao_i2c_t *n = b->primeira; n; n = b->primeira) {
+        if (n->endereco != t->endereco || !leitura_de_registro(b, n) ||
+            n->escrita[0] != (uint32_t)t->escrita[0] + total || total + n->tam_leitura > BARRAMENTO_RAJADA) break;
+        ultimo->proxima = retirar_primeira(b);
+        ultimo = n;
+        total += n->tam_leitura;
+    }
+    if (ultimo == t) return false;
+
+    b->registro_rajada = t->escrita[0];
+    b->rajada = (transacao_i2c_t){
+        .endereco = t->endereco,
+        .escrita = &b->registro_rajada,
+        .tam_escrita = 1,
+        .leitura = b->dados_rajada,
+        .tam_leitura = (uint16_t)total,
+        .estado = TRANSACAO_EM_CURSO,
+    };
+    return true;
+}
+
+// Tira a próxima transação da fila e a inicia no controlador (com a seção crítica)
+static void iniciar_proxima(barramento_t *b) {
+    if (!b->primeira) return;
+    transacao_i2c_t *t = retirar_primeira(b);
+    if (reunir_rajada(b, t)) {
+        b->membros = t;
+        t = &b->rajada;
+    }
+
+    b->atual = t;
+    b->montados = 0;
+    b->abortada = false;
+    b->abort_pedido = false;
+    b->fonte_abort = 0;
+    b->inicio_atual_us = time_us_64();
+
+    // O endereço de destino só pode mudar com o controlador desligado
+    i2c_hw_t *hw = i2c_get_hw(b->i2c);
+    hw->enable = 0;
+    hw->tar = t->endereco;
+    hw->enable = 1;
+
+    // A leitura fica armada antes dos comandos que a provocam
+    if (t->tam_leitura > 0) {
+        dma_channel_configure(b->canal_rx, &b->config_rx, t->leitura, &hw->data_cmd, t->tam_leitura, true);
+    }
+    montar_bloco(b, 0);
+    b->enviando = 0;
+    dma_channel_configure(b->canal_tx, &b->config_tx, &hw->data_cmd, b->comandos[0], b->tam_bloco[0], true);
+    montar_bloco(b, 1);
+}
+
+// Para os dois canais sem deixar uma interrupção falsa de fim de bloco para trás
+static void parar_dma(barramento_t *b) {
+    dma_channel_set_irq0_enabled(b->canal_tx, false);
+    dma_channel_abort(b->canal_tx);
+    dma_channel_abort(b->canal_rx);
+    dma_channel_acknowledge_irq0(b->canal_tx);
+    dma_channel_set_irq0_enabled(b->canal_tx, true);
+}
+
+// Entrega o resultado a quem enfileirou a transação (com a seção crítica, que fica
+// livre durante o callback: ele pode enfileirar)
+static void entregar(barramento_t *b, transacao_i2c_t *t, estado_transacao_t resultado, uint64_t agora) {
+    if (t->dispositivo >= 0) {
+        estatisticas_dispositivo_t *d = &b->dispositivos[t->dispositivo].estatisticas;
+        uint32_t latencia = (uint32_t)(agora - t->enfileirada_us);
+        d->transacoes++;
+        if (resultado == TRANSACAO_NACK) d->nacks++;
+        else if (resultado != TRANSACAO_OK) d->erros++;
+        if (t->prazo_us && agora > t->prazo_us) d->prazos_perdidos++;
+        d->soma_latencia_us += latencia;
+        if (latencia > d->maior_latencia_us) d->maior_latencia_us = latencia;
+    }
+
+    t->estado = resultado;
+    if (t->concluida) {
+        critical_section_exit(&b->secao);
+        t->concluida(t);
+        critical_section_enter_blocking(&b->secao);
+    }
+}
+
+// Fecha a transação atual com o resultado, avisa quem a enfileirou e começa a próxima
+// Chamada com a seção crítica
+static void concluir(barramento_t *b, estado_transacao_t resultado) {
+    transacao_i2c_t *t = b->atual;
+    estatisticas_barramento_t *e = &b->estatisticas;
+    uint64_t agora = time_us_64();
+
+    e->transacoes++;
+    e->ocupado_us += agora - b->inicio_atual_us;
+    if (resultado == TRANSACAO_OK) e->bytes += (uint32_t)t->tam_escrita + t->tam_leitura;
+    else if (resultado == TRANSACAO_NACK) e->nacks++;
+    else e->erros++;
+
+    b->atual = NULL;
+    if (t != &b->rajada) {
+        entregar(b, t, resultado, agora);
+    } else {
+        // Distribui os dados antes de qualquer callback: a próxima rajada reusa o buffer
+        transacao_i2c_t *m = b->membros;
+        b->membros = NULL;
+        uint32_t posicao = 0;
+        for (transacao_i2c_t *n = m; n; n = n->proxima) {
+            if (resultado == TRANSACAO_OK) memcpy(n->leitura, &b->dados_rajada[posicao], n->tam_leitura);
+            posicao += n->tam_leitura;
+            if (n != m) e->coalescidas++;
+        }
+        while (m) {
+            transacao_i2c_t *seguinte = m->proxima;   // O callback pode enfileirar 'm' de novo
+            entregar(b, m, resultado, agora);
+            m = seguinte;
+        }
+    }
+    if (!b->atual) iniciar_proxima(b);
+}
+
+// STOP no barramento: a transação terminou (com ou sem abort)
+static void tratar_fim(barramento_t *b) {
+    i2c_hw_t *hw = i2c_get_hw(b->i2c);
+    transacao_i2c_t *t = b->atual;
+    if (!t) return;                                   // STOP sem transação: nada a fazer
+
+    estado_transacao_t resultado = TRANSACAO_OK;
+    if (b->abortada) {
+        const uint32_t nack = I2C_IC_TX_ABRT_SOURCE_ABRT_7B_ADDR_NOACK_BITS | I2C_IC_TX_ABRT_SOURCE_ABRT_TXDATA_NOACK_BITS;
+        resultado = (b->fonte_abort & nack) && !b->abort_pedido ? TRANSACAO_NACK : TRANSACAO_ERRO;
+    } else if (t->tam_leitura > 0) {
+        // O último byte pode chegar ao FIFO junto com o STOP: o DMA termina em poucos ciclos
+        for (int i = 0; i < 1000 && dma_channel_is_busy(b->canal_rx); i++) tight_loop_contents();
+        if (dma_channel_is_busy(b->canal_rx)) resultado = TRANSACAO_ERRO;
+    }
+    if (resultado != TRANSACAO_OK) {
+        parar_dma(b);
+        while (hw->rxflr) (void)hw->data_cmd;         // Descarta o que sobrou no FIFO de recepção
+    }
+    concluir(b, resultado);
+}
+
+static void tratar_i2c(barramento_t *b) {
+    i2c_hw_t *hw = i2c_get_hw(b->i2c);
+    critical_section_enter_blocking(&b->secao);
+    uint32_t pendentes = hw->intr_stat;
+    if (pendentes & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        // O controlador esvazia o FIFO de envio e fica parado até a leitura de clr_tx_abrt
+        parar_dma(b);
+        b->fonte_abort = hw->tx_abrt_source;
+        b->abortada = true;
+        (void)hw->clr_tx_abrt;
+    }
+    if (pendentes & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+        (void)hw->clr_stop_det;
+        tratar_fim(b);
+    }
+    critical_section_exit(&b->secao);
+}
+
+static void tratar_i2c0(void) {
+    tratar_i2c(&barramentos[0]);
+}
+
+static void tratar_i2c1(void) {
+    tratar_i2c(&barramentos[1]);
+}
+
+// Fim de um bloco de comandos: o DMA passa para o outro, e este é montado de novo
+static void tratar_dma(void) {
+    for (int i = 0; i < BARRAMENTO_NUM; i++) {
+        barramento_t *b = &barramentos[i];
+        if (!b->iniciado || !dma_channel_get_irq0_status(b->canal_tx)) continue;
+        dma_channel_acknowledge_irq0(b->canal_tx);
+
+        critical_section_enter_blocking(&b->secao);
+        uint8_t outro = b->enviando ^ 1;
+        if (b->atual && !b->abortada && b->tam_bloco[outro] > 0) {
+            b->enviando = outro;
+            dma_channel_transfer_from_buffer_now(b->canal_tx, b->comandos[outro], b->tam_bloco[outro]);
+            montar_bloco(b, outro ^ 1);
+        }
+        critical_section_exit(&b->secao);
+    }
+}
+
+/* ---------- Funções Públicas ---------- */
+
+uint barramento_iniciar(i2c_inst_t *i2c, uint frequencia) {
+    uint indice = i2c_hw_index(i2c);
+    barramento_t *b = &barramentos[indice];
+    uint real = i2c_init(i2c, frequencia);
+    b->frequencia_pedida = frequencia;
+    b->frequencia = real;
+    if (b->iniciado) return real;
+
+    b->i2c = i2c;
+    critical_section_init(&b->secao);
+
+    // Envio: comandos de 16 bits da memória para IC_DATA_CMD, no ritmo do FIFO de envio
+    b->canal_tx = (uint)dma_claim_unused_channel(true);
+    b->config_tx = dma_channel_get_default_config(b->canal_tx);
+    channel_config_set_transfer_data_size(&b->config_tx, DMA_SIZE_16);
+    channel_config_set_read_increment(&b->config_tx, true);
+    channel_config_set_write_increment(&b->config_tx, false);
+    channel_config_set_dreq(&b->config_tx, i2c_get_dreq(i2c, true));
+
+    // Recepção: bytes de IC_DATA_CMD para o destino, no ritmo do FIFO de recepção
+    b->canal_rx = (uint)dma_claim_unused_channel(true);
+    b->config_rx = dma_channel_get_default_config(b->canal_rx);
+    channel_config_set_transfer_data_size(&b->config_rx, DMA_SIZE_8);
+    channel_config_set_read_increment(&b->config_rx, false);
+    channel_config_set_write_increment(&b->config_rx, true);
+    channel_config_set_dreq(&b->config_rx, i2c_get_dreq(i2c, false));
+
+    i2c_hw_t *hw = i2c_get_hw(i2c);
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS;
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+
+    // A interrupção do DMA é compartilhada com quem mais usar DMA_IRQ_0
+    static bool dma_registrado = false;
+    if (!dma_registrado) {
+        irq_add_shared_handler(DMA_IRQ_0, tratar_dma, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+        dma_registrado = true;
+    }
+    dma_channel_set_irq0_enabled(b->canal_tx, true);
+
+    uint irq = indice ? I2C1_IRQ : I2C0_IRQ;
+    irq_set_exclusive_handler(irq, indice ? tratar_i2c1 : tratar_i2c0);
+    irq_set_enabled(irq, true);
+
+    b->estatisticas.inicio_us = time_us_64();
+    b->iniciado = true;
+    return real;
+}
+
+uint barramento_registrar(i2c_inst_t *i2c, uint8_t endereco, const char *nome, uint frequencia_maxima,
+                          prioridade_i2c_t prioridade, uint32_t opcoes) {
+    barramento_t *b = obter(i2c);
+    if (!b) return 0;
+
+    critical_section_enter_blocking(&b->secao);
+    int8_t i = procurar_dispositivo(b, endereco);
+    if (i < 0) {
+        if (b->num_dispositivos == BARRAMENTO_MAX_DISPOSITIVOS) {
+            critical_section_exit(&b->secao);
+            return 0;
+        }
+        i = (int8_t)b->num_dispositivos++;
+    }
+    b->dispositivos[i] = (dispositivo_t){
+        .endereco = endereco,
+        .nome = nome,
+        .frequencia_maxima = frequencia_maxima,
+        .prioridade = prioridade == PRIORIDADE_PADRAO ? PRIORIDADE_NORMAL : prioridade,
+        .opcoes = opcoes,
+    };
+
+    uint desejada = b->frequencia_pedida;
+    for (int k = 0; k < b->num_dispositivos; k++) {
+        if (b->dispositivos[k].frequencia_maxima < desejada) desejada = b->dispositivos[k].frequencia_maxima;
+    }
+    critical_section_exit(&b->secao);
+
+    // A frequência só muda com o controlador parado: espera a fila esvaziar
+    while (true) {
+        critical_section_enter_blocking(&b->secao);
+        if (!b->atual && !b->primeira) {
+            b->frequencia = i2c_set_baudrate(i2c, desejada);
+            critical_section_exit(&b->secao);
+            return b->frequencia;
+        }
+        critical_section_exit(&b->secao);
+        tight_loop_contents();
+    }
+}
+
+uint barramento_frequencia(i2c_inst_t *i2c) {
+    barramento_t *b = obter(i2c);
+    return b ? b->frequencia : 0;
+}
+
+bool barramento_enfileirar(i2c_inst_t *i2c, transacao_i2c_t *t) {
+    barramento_t *b = obter(i2c);
+    if (!b || (uint32_t)t->tam_escrita + t->tam_leitura == 0) return false;
+
+    t->proxima = NULL;
+    t->estado = TRANSACAO_NA_FILA;
+    t->enfileirada_us = time_us_64();
+    critical_section_enter_blocking(&b->secao);
+    t->dispositivo = procurar_dispositivo(b, t->endereco);
+    t->prioridade_efetiva = t->prioridade != PRIORIDADE_PADRAO ? t->prioridade
+                          : t->dispositivo >= 0 ? b->dispositivos[t->dispositivo].prioridade
+                          : PRIORIDADE_NORMAL;
+
+    // Depois de todas que saem antes dela (ou empatam, para manter a ordem de chegada)
+    transacao_i2c_t **p = &b->primeira;
+    while (*p && !vem_antes(t, *p)) p = &(*p)->proxima;
+    t->proxima = *p;
+    *p = t;
+    if (++b->estatisticas.fila > b->estatisticas.maior_fila) b->estatisticas.maior_fila = b->estatisticas.fila;
+    if (!b->atual) iniciar_proxima(b);
+    critical_section_exit(&b->secao);
+    return true;
+}
+
+bool barramento_aguardar(i2c_inst_t *i2c, transacao_i2c_t *t, uint32_t limite_us) {
+    barramento_t *b = obter(i2c);
+    if (!b) return false;
+
+    uint64_t limite = time_us_64() + limite_us;
+    while (!transacao_concluida(t)) {
+        if (time_us_64() >= limite) {
+            critical_section_enter_blocking(&b->secao);
+            if (t->estado == TRANSACAO_NA_FILA) {
+                // Ainda na fila: sai dela sem tocar no barramento
+                transacao_i2c_t **p = &b->primeira;
+                while (*p != t) p = &(*p)->proxima;
+                *p = t->proxima;
+                b->estatisticas.fila--;
+                entregar(b, t, TRANSACAO_ERRO, time_us_64());
+            } else if (t->estado == TRANSACAO_EM_CURSO && !b->abort_pedido) {
+                // O controlador aborta, gera STOP e a interrupção conclui com erro
+                b->abort_pedido = true;
+                i2c_get_hw(i2c)->enable |= I2C_IC_ENABLE_ABORT_BITS;
+                limite = time_us_64() + limite_us;
+            } else if (t->estado == TRANSACAO_EM_CURSO) {
+                // Nem o abort terminou (SCL preso): desiste da transação
+                parar_dma(b);
+                i2c_get_hw(i2c)->enable = 0;
+                concluir(b, TRANSACAO_ERRO);
+            }
+            critical_section_exit(&b->secao);
+        }
+        tight_loop_contents();
+    }
+    return t->estado == TRANSACAO_OK;
+}
+
+int barramento_escrever(i2c_inst_t *i2c, uint8_t endereco, const uint8_t *dados, size_t tamanho) {
+    if (tamanho > UINT16_MAX) return PICO_ERROR_GENERIC;
+    transacao_i2c_t t = {
+        .endereco = endereco,
+        .escrita = dados,
+        .tam_escrita = (uint16_t)tamanho,
+        .prazo_us = time_us_64() + BARRAMENTO_LIMITE_US(tamanho),
+    };
+    if (!barramento_enfileirar(i2c, &t)) return PICO_ERROR_GENERIC;
+    return barramento_aguardar(i2c, &t, BARRAMENTO_LIMITE_US(tamanho)) ? (int)tamanho : PICO_ERROR_GENERIC;
+}
+
+int barramento_ler(i2c_inst_t *i2c, uint8_t endereco, const uint8_t *escrita, size_t tam_escrita,
+                   uint8_t *leitura, size_t tam_leitura) {
+    if (tam_escrita > UINT16_MAX || tam_leitura > UINT16_MAX || tam_leitura == 0) return PICO_ERROR_GENERIC;
+    transacao_i2c_t t = {
+        .endereco = endereco,
+        .escrita = escrita,
+        .tam_escrita = (uint16_t)tam_escrita,
+        .leitura = leitura,
+        .tam_leitura = (uint16_t)tam_leitura,
+        .prazo_us = time_us_64() + BARRAMENTO_LIMITE_US(tam_escrita + tam_leitura),
+    };
+    if (!barramento_enfileirar(i2c, &t)) return PICO_ERROR_GENERIC;
+    return barramento_aguardar(i2c, &t, BARRAMENTO_LIMITE_US(tam_escrita + tam_leitura)) ? (int)tam_leitura : PICO_ERROR_GENERIC;
+}
+
+const estatisticas_barramento_t *barramento_estatisticas(i2c_inst_t *i2c) {
+    barramento_t *b = obter(i2c);
+    return b ? &b->estatisticas : NULL;
+}
+
+const estatisticas_dispositivo_t *barramento_dispositivo(i2c_inst_t *i2c, uint indice,
+                                                         const char **nome, uint8_t *endereco) {
+    barramento_t *b = obter(i2c);
+    if (!b || indice >= b->num_dispositivos) return NULL;
+    if (nome) *nome = b->dispositivos[indice].nome;
+    if (endereco) *endereco = b->dispositivos[indice].endereco;
+    return &b->dispositivos[indice].estatisticas;
+}
+
+uint32_t barramento_ocupacao_permil(i2c_inst_t *i2c) {
+    barramento_t *b = obter(i2c);
+    if (!b) return 0;
+    critical_section_enter_blocking(&b->secao);
+    uint64_t ocupado = b->estatisticas.ocupado_us;
+    uint64_t decorrido = time_us_64() - b->estatisticas.inicio_us;
+    critical_section_exit(&b->secao);
+    return decorrido ? (uint32_t)(ocupado * 1000 / decorrido) : 0;
+}
@@ -0,0 +1,163 @@
+#ifndef BARRAMENTO_I2C_H
+#define BARRAMENTO_I2C_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "hardware/i2c.h"
+
+/* ---------- Barramentos I2C com DMA ---------- */
+// Transações I2C executadas por DMA, sem a CPU esperando byte a byte: cada
+// barramento (i2c0, i2c1) tem uma fila de transações, e uma termina e a
+// seguinte começa dentro da interrupção do controlador. Quem enfileira segue
+// trabalhando e fica sabendo do fim pelo estado da transação ou por callback.
+//
+// Uma transação é uma escrita, uma leitura ou uma escrita seguida de leitura
+// com START repetido (o caso de "ler registro"). O controlador I2C recebe um
+// comando de 16 bits por byte (dado + bits de leitura, RESTART e STOP), que
+// é montado em dois blocos alternados: um é enviado pelo DMA enquanto a
+// interrupção do canal prepara o outro. A leitura vai do FIFO de recepção
+// direto para o destino por um segundo canal de DMA.
+//
+// O fim é o STOP no barramento (interrupção STOP_DET), que o controlador
+// também gera depois de abortar; um NACK aparece antes como TX_ABRT.
+//
+// A fila é ordenada: primeiro pela prioridade, depois pelo prazo (o mais
+// próximo antes; sem prazo por último) e, no empate, pela ordem de chegada.
+// Uma prioridade alta que nunca para de chegar atrasa as baixas para sempre.
+// Os dispositivos registrados têm estatísticas próprias (latência do
+// enfileiramento ao fim, NACKs, erros, prazos perdidos), uma prioridade
+// padrão, e limitam a frequência do barramento: ela é a maior que todos os
+// registrados aceitam. Leituras de registros seguidos do mesmo dispositivo
+// (com auto-incremento), uma atrás da outra na fila, saem numa só rajada.
+//
+// Todo acesso a um barramento iniciado aqui precisa passar por este módulo:
+// misturar com i2c_write_blocking()/i2c_read_blocking() embaralha os FIFOs.
+
+#define BARRAMENTO_NUM       2       // i2c0 e i2c1
+#define BARRAMENTO_BLOCO     32      // Comandos por bloco de DMA (dois blocos por barramento)
+#define BARRAMENTO_MAX_DISPOSITIVOS 6        // Registrados por barramento
+#define BARRAMENTO_RAJADA    64      // Maior leitura coalescida, em bytes
+
+// Limite usado pelos atalhos bloqueantes: folga fixa + um byte a 100 kHz com sobra
+#define BARRAMENTO_LIMITE_US(bytes) (2000u + 200u * (uint32_t)(bytes))
+
+/* ---------- Transações ---------- */
+typedef enum {
+    TRANSACAO_LIVRE,                 // Nunca enfileirada
+    TRANSACAO_NA_FILA,
+    TRANSACAO_EM_CURSO,
+    TRANSACAO_OK,                    // Estados a partir daqui: concluída
+    TRANSACAO_NACK,                  // Dispositivo não respondeu (endereço ou dado)
+    TRANSACAO_ERRO,                  // Perda de arbitragem, tempo esgotado etc.
+} estado_transacao_t;
+
+// PRIORIDADE_PADRAO usa a do dispositivo registrado (NORMAL se não houver registro)
+typedef enum {
+    PRIORIDADE_PADRAO,
+    PRIORIDADE_BAIXA,
+    PRIORIDADE_NORMAL,
+    PRIORIDADE_ALTA,
+} prioridade_i2c_t;
+
+typedef struct transacao_i2c transacao_i2c_t;
+
+// Chamado da interrupção do barramento quando a transação termina (com sucesso ou não),
+// fora da seção crítica do barramento: pode enfileirar outra transação, não pode esperar por uma
+typedef void (*transacao_concluida_cb)(transacao_i2c_t *t);
+
+// Pertence a quem enfileira e precisa continuar válida (com os buffers) até concluir
+// Os bytes de 'escrita' são lidos aos poucos, durante a transação: não os altere antes do fim
+struct transacao_i2c {
+    uint8_t endereco;                // Endereço de 7 bits
+    const uint8_t *escrita;          // Bytes enviados primeiro (pode ser NULL se tam_escrita = 0)
+    uint16_t tam_escrita;
+    uint8_t *leitura;                // Destino dos bytes lidos depois (NULL se tam_leitura = 0)
+    uint16_t tam_leitura;
+    transacao_concluida_cb concluida;    // Opcional
+    void *contexto;                  // Livre para quem enfileira
+    prioridade_i2c_t prioridade;
+    uint64_t prazo_us;               // Quando deveria terminar (time_us_64), 0 = sem prazo
+    volatile estado_transacao_t estado;
+
+    // Uso interno do barramento
+    transacao_i2c_t *proxima;        // Fila, ou membros de uma rajada
+    uint64_t enfileirada_us;
+    prioridade_i2c_t prioridade_efetiva;
+    int8_t dispositivo;              // Índice do registro, -1 se não registrado
+};
+
+static inline bool transacao_concluida(const transacao_i2c_t *t) {
+    return t->estado >= TRANSACAO_OK;
+}
+
+/* ---------- Estatísticas ---------- */
+typedef struct {
+    uint32_t transacoes;             // Concluídas, com sucesso ou não
+    uint32_t nacks;
+    uint32_t erros;                  // Falhas que não foram NACK
+    uint32_t bytes;                  // Bytes escritos e lidos com sucesso
+    uint64_t ocupado_us;             // Tempo com transação em curso
+    uint64_t inicio_us;              // Início da contagem (barramento_iniciar)
+    uint16_t fila;                   // Transações esperando agora
+    uint16_t maior_fila;
+    uint32_t coalescidas;            // Transações que saíram dentro da rajada de outra
+} estatisticas_barramento_t;
+
+/* ---------- Dispositivos ---------- */
+#define DISPOSITIVO_AUTO_INCREMENTO (1u << 0)   // Lê registros seguidos numa só leitura
+
+typedef struct {
+    uint32_t transacoes;             // Concluídas, com sucesso ou não
+    uint32_t nacks;
+    uint32_t erros;
+    uint32_t prazos_perdidos;        // Concluídas depois do prazo
+    uint64_t soma_latencia_us;       // Do enfileiramento ao fim
+    uint32_t maior_latencia_us;
+} estatisticas_dispositivo_t;
+
+/* ---------- API dos Barramentos ---------- */
+
+// Inicializa o controlador na frequência pedida e reserva os dois canais de DMA
+// Retorna a frequência real, como i2c_init()
+uint barramento_iniciar(i2c_inst_t *i2c, uint frequencia);
+
+// Registra um dispositivo do barramento com o nome usado nas estatísticas, a maior
+// frequência que ele aceita, a prioridade das transações com PRIORIDADE_PADRAO e as
+// opções (DISPOSITIVO_*). O barramento passa para a maior frequência aceita por todos
+// os registrados, sem passar da pedida em barramento_iniciar(); se precisar mudar,
+// espera o barramento ficar livre. Retorna a frequência real (0 se não houver espaço)
+uint barramento_registrar(i2c_inst_t *i2c, uint8_t endereco, const char *nome, uint frequencia_maxima,
+                          prioridade_i2c_t prioridade, uint32_t opcoes);
+
+// Frequência atual do barramento (0 se não foi iniciado)
+uint barramento_frequencia(i2c_inst_t *i2c);
+
+// Põe a transação na fila, na posição da sua prioridade e do seu prazo
+// Retorna false se ela for vazia ou o barramento não foi iniciado
+// Pode ser chamada de interrupções (inclusive do callback de outra transação)
+bool barramento_enfileirar(i2c_inst_t *i2c, transacao_i2c_t *t);
+
+// Espera a transação concluir; se passar de 'limite_us', aborta a transação
+// Retorna true se ela terminou com TRANSACAO_OK
+bool barramento_aguardar(i2c_inst_t *i2c, transacao_i2c_t *t, uint32_t limite_us);
+
+// Atalhos bloqueantes, com o retorno das funções do SDK: bytes transferidos
+// (escritos em barramento_escrever, lidos em barramento_ler) ou PICO_ERROR_GENERIC
+// Usam a prioridade do dispositivo e o limite de espera como prazo
+int barramento_escrever(i2c_inst_t *i2c, uint8_t endereco, const uint8_t *dados, size_t tamanho);
+int barramento_ler(i2c_inst_t *i2c, uint8_t endereco, const uint8_t *escrita, size_t tam_escrita,
+                   uint8_t *leitura, size_t tam_leitura);
+
+// Contadores do barramento (NULL se não foi iniciado)
+const estatisticas_barramento_t *barramento_estatisticas(i2c_inst_t *i2c);
+
+// Estatísticas do dispositivo registrado de número 'indice' (a partir de 0), com seu
+// nome e endereço; NULL se não houver esse registro
+const estatisticas_dispositivo_t *barramento_dispositivo(i2c_inst_t *i2c, uint indice,
+                                                         const char **nome, uint8_t *endereco);
+
+// Fração do tempo desde barramento_iniciar() com o barramento ocupado, em décimos de %
+uint32_t barramento_ocupacao_permil(i2c_inst_t *i2c);
+
+#endif // BARRAMENTO_I2C_H
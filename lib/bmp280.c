@@ -1,5 +1,7 @@
 #include "bmp280.h"
+#include "pico/time.h"
 #include "hardware/i2c.h"
+#include "barramento_i2c.h"
 
 /* ---------- Configurações do Sensor BMP280 ---------- */
 #define ADDR _u(0x77)
@@ -7,43 +9,93 @@
 /* ---------- Funções Públicas ---------- */
 
 void bmp280_init(i2c_inst_t *i2c) {
+    const struct bmp280_config config = BMP280_CONFIG_DEFAULT;
+    bmp280_configure(i2c, &config);
+}
+
+bool bmp280_configure(i2c_inst_t *i2c, const struct bmp280_config *config) {
     uint8_t buf[2];
-    
-    // Configura registro de configuração
-    const uint8_t reg_config_val = ((0x04 << 5) | (0x05 << 2)) & 0xFC;
+    const uint8_t reg_ctrl_meas_val = (uint8_t)((config->osrs_t & 0x07) << 5) | (uint8_t)((config->osrs_p & 0x07) << 2);
+
+    // Modo sleep, para que a escrita em REG_CONFIG não seja ignorada
+    buf[0] = REG_CTRL_MEAS;
+    buf[1] = reg_ctrl_meas_val | BMP280_MODE_SLEEP;
+    if (barramento_escrever(i2c, ADDR, buf, 2) != 2) return false;
+
+    // Configura registro de configuração (pausa e filtro IIR; SPI de 3 fios desligado)
     buf[0] = REG_CONFIG;
-    buf[1] = reg_config_val;
-    i2c_write_blocking(i2c, ADDR, buf, 2, false);
+    buf[1] = (uint8_t)((config->standby & 0x07) << 5) | (uint8_t)((config->filter & 0x07) << 2);
+    if (barramento_escrever(i2c, ADDR, buf, 2) != 2) return false;
 
-    // Configura registro de controle de medição
-    const uint8_t reg_ctrl_meas_val = (0x01 << 5) | (0x03 << 2) | (0x03);
+    // Configura registro de controle de medição e inicia as conversões contínuas
     buf[0] = REG_CTRL_MEAS;
-    buf[1] = reg_ctrl_meas_val;
-    i2c_write_blocking(i2c, ADDR, buf, 2, false);
+    buf[1] = reg_ctrl_meas_val | BMP280_MODE_NORMAL;
+    return barramento_escrever(i2c, ADDR, buf, 2) == 2;
 }
 
-void bmp280_read_raw(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure) {
-    uint8_t buf[6];
-    uint8_t reg = REG_PRESSURE_MSB;
-    
-    i2c_write_blocking(i2c, ADDR, &reg, 1, true);
-    i2c_read_blocking(i2c, ADDR, buf, 6, false);
+// Fator de sobreamostragem (0 para SKIP)
+static uint32_t oversampling_factor(uint8_t osrs) {
+    return (osrs == BMP280_OSRS_SKIP) ? 0 : 1u << ((osrs > BMP280_OSRS_X16 ? BMP280_OSRS_X16 : osrs) - 1);
+}
 
-    *pressure = (buf[0] << 12) | (buf[1] << 4) | (buf[2] >> 4);
-    *temp = (buf[3] << 12) | (buf[4] << 4) | (buf[5] >> 4);
+uint32_t bmp280_measurement_time_us(const struct bmp280_config *config) {
+    // t_measure,max = 1,25 + 2,3 * osrs_t + (2,3 * osrs_p + 0,575) ms
+    uint32_t tempo = 1250 + 2300 * oversampling_factor(config->osrs_t);
+    if (config->osrs_p != BMP280_OSRS_SKIP) tempo += 2300 * oversampling_factor(config->osrs_p) + 575;
+    return tempo;
+}
+
+uint32_t bmp280_cycle_time_us(const struct bmp280_config *config) {
+    static const uint32_t STANDBY_US[8] = {500, 62500, 125000, 250000, 500000, 1000000, 2000000, 4000000};
+    return bmp280_measurement_time_us(config) + STANDBY_US[config->standby & 0x07];
+}
+
+bool bmp280_read_burst(i2c_inst_t *i2c, struct bmp280_reading *reading) {
+    // status, ctrl_meas, config, (reservado), pressão (3 bytes), temperatura (3 bytes)
+    uint8_t buf[10];
+    uint8_t reg = REG_STATUS;
+
+    if (barramento_ler(i2c, ADDR, &reg, 1, buf, sizeof(buf)) != (int)sizeof(buf)) return false;
+
+    if (buf[0] & BMP280_STATUS_IM_UPDATE) return false;           // Calibração sendo copiada
+    if ((buf[1] & 0x03) != BMP280_MODE_NORMAL) return false;      // Sem conversões novas
+
+    int32_t pressure = (buf[4] << 12) | (buf[5] << 4) | (buf[6] >> 4);
+    int32_t temp = (buf[7] << 12) | (buf[8] << 4) | (buf[9] >> 4);
+    if (pressure == 0x80000 || temp == 0x80000) return false;     // Valor de reset: nenhuma conversão ainda
+
+    // Com a conversão em andamento (MEASURING), os registros ainda têm o resultado
+    // anterior. Um resultado novo chegou se MEASURING caiu desde a leitura anterior,
+    // ou se desde o último resultado novo já coube um ciclo inteiro (em modo normal o
+    // sensor conclui uma conversão a cada ciclo). Valores iguais não provam nada: com
+    // o filtro IIR numa sala estável, conversões seguidas repetem os dados brutos
+    const struct bmp280_config ativa = {
+        .osrs_t = buf[1] >> 5, .osrs_p = (buf[1] >> 2) & 0x07,
+        .filter = (buf[2] >> 2) & 0x07, .standby = buf[2] >> 5,
+    };
+    bool measuring = (buf[0] & BMP280_STATUS_MEASURING) != 0;
+    uint64_t agora = time_us_64();
+    reading->fresh = reading->fresh_us == 0 ||
+                     (reading->measuring && !measuring) ||
+                     agora - reading->fresh_us >= bmp280_cycle_time_us(&ativa) ||
+                     temp != reading->temp || pressure != reading->pressure;
+    if (reading->fresh) reading->fresh_us = agora;
+    reading->measuring = measuring;
+    reading->temp = temp;
+    reading->pressure = pressure;
+    return true;
 }
 
 void bmp280_reset(i2c_inst_t *i2c) {
     uint8_t buf[2] = { REG_RESET, 0xB6 };
-    i2c_write_blocking(i2c, ADDR, buf, 2, false);
+    barramento_escrever(i2c, ADDR, buf, 2);
 }
 
 void bmp280_get_calib_params(i2c_inst_t *i2c, struct bmp280_calib_param* params) {
     uint8_t buf[NUM_CALIB_PARAMS] = { 0 };
     uint8_t reg = REG_DIG_T1_LSB;
     
-    i2c_write_blocking(i2c, ADDR, &reg, 1, true);
-    i2c_read_blocking(i2c, ADDR, buf, NUM_CALIB_PARAMS, false);
+    barramento_ler(i2c, ADDR, &reg, 1, buf, NUM_CALIB_PARAMS);
 
     // Parâmetros de calibração de temperatura
     params->dig_t1 = (uint16_t)(buf[1] << 8) | buf[0];
@@ -61,62 +113,3 @@ void bmp280_get_calib_params(i2c_inst_t *i2c, struct bmp280_calib_param* params)
     params->dig_p8 = (int16_t)(buf[21] << 8) | buf[20];
     params->dig_p9 = (int16_t)(buf[23] << 8) | buf[22];
 }
-
-/* ---------- Funções de Conversão ---------- */
-
-// Função intermediária que calcula temperatura de resolução fina
-// Usada tanto para conversões de pressão quanto de temperatura
-int32_t bmp280_convert(int32_t temp, struct bmp280_calib_param* params) {
-    // Usa compensação de ponto fixo de 32 bits implementada no datasheet
-    int32_t var1, var2;
-    
-    var1 = ((((temp >> 3) - ((int32_t)params->dig_t1 << 1))) * 
-            ((int32_t)params->dig_t2)) >> 11;
-    
-    var2 = (((((temp >> 4) - ((int32_t)params->dig_t1)) * 
-             ((temp >> 4) - ((int32_t)params->dig_t1))) >> 12) * 
-            ((int32_t)params->dig_t3)) >> 14;
-    
-    return var1 + var2;
-}
-
-int32_t bmp280_convert_temp(int32_t temp, struct bmp280_calib_param* params) {
-    // Utiliza parâmetros de calibração do BMP280 para compensar valor de temperatura
-    int32_t t_fine = bmp280_convert(temp, params);
-    return (t_fine * 5 + 128) >> 8;
-}
-
-int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_calib_param* params) {
-    // Utiliza parâmetros de calibração do BMP280 para compensar valor de pressão
-    int32_t t_fine = bmp280_convert(temp, params);
-    int32_t var1, var2;
-    uint32_t converted = 0.0;
-    
-    var1 = (((int32_t)t_fine) >> 1) - (int32_t)64000;
-    var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * ((int32_t)params->dig_p6);
-    var2 += ((var1 * ((int32_t)params->dig_p5)) << 1);
-    var2 = (var2 >> 2) + (((int32_t)params->dig_p4) << 16);
-    
-    var1 = (((params->dig_p3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + 
-            ((((int32_t)params->dig_p2) * var1) >> 1)) >> 18;
-    var1 = ((((32768 + var1)) * ((int32_t)params->dig_p1)) >> 15);
-    
-    if (var1 == 0) {
-        return 0;  // Evita exceção causada por divisão por zero
-    }
-    
-    converted = (((uint32_t)(((int32_t)1048576) - pressure) - (var2 >> 12))) * 3125;
-    
-    if (converted < 0x80000000) {
-        converted = (converted << 1) / ((uint32_t)var1);
-    } else {
-        converted = (converted / (uint32_t)var1) * 2;
-    }
-    
-    var1 = (((int32_t)params->dig_p9) * 
-            ((int32_t)(((converted >> 3) * (converted >> 3)) >> 13))) >> 12;
-    var2 = (((int32_t)(converted >> 2)) * ((int32_t)params->dig_p8)) >> 13;
-    converted = (uint32_t)((int32_t)converted + ((var1 + var2 + params->dig_p7) >> 4));
-    
-    return converted;
-}
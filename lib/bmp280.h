@@ -3,16 +3,28 @@
 
 #include "hardware/i2c.h"
 #include <stdint.h>
+#include <stdbool.h>
+#include "bmp280_compensacao.h"    // Parâmetros de calibração e conversão das leituras
 
 /* ---------- Configurações do Sensor BMP280 ---------- */
 #define ADDR _u(0x77)
+#define BMP280_I2C_FREQ_MAX (3400 * 1000)   // Modo de alta velocidade do datasheet
 #define NUM_CALIB_PARAMS 24
 
 /* ---------- Registros de Controle ---------- */
 #define REG_CONFIG _u(0xF5)
 #define REG_CTRL_MEAS _u(0xF4)
+#define REG_STATUS _u(0xF3)
 #define REG_RESET _u(0xE0)
 
+/* ---------- Bits do Registro de Status ---------- */
+#define BMP280_STATUS_MEASURING _u(0x08)   // Conversão em andamento
+#define BMP280_STATUS_IM_UPDATE _u(0x01)   // Cópia da calibração (NVM) em andamento
+
+/* ---------- Modos de Operação ---------- */
+#define BMP280_MODE_SLEEP  _u(0x00)
+#define BMP280_MODE_NORMAL _u(0x03)        // Conversões contínuas, com pausa 'standby' entre elas
+
 /* ---------- Registros de Dados de Temperatura ---------- */
 #define REG_TEMP_MSB _u(0xFA)
 #define REG_TEMP_LSB _u(0xFB)
@@ -51,32 +63,64 @@
 #define REG_DIG_P9_LSB _u(0x9E)
 #define REG_DIG_P9_MSB _u(0x9F)
 
-/* ---------- Estrutura de Parâmetros de Calibração ---------- */
-struct bmp280_calib_param {
-    // Parâmetros de calibração de temperatura
-    uint16_t dig_t1;
-    int16_t dig_t2;
-    int16_t dig_t3;
-
-    // Parâmetros de calibração de pressão
-    uint16_t dig_p1;
-    int16_t dig_p2;
-    int16_t dig_p3;
-    int16_t dig_p4;
-    int16_t dig_p5;
-    int16_t dig_p6;
-    int16_t dig_p7;
-    int16_t dig_p8;
-    int16_t dig_p9;
+/* ---------- Opções de Medição ---------- */
+// Códigos dos campos de REG_CTRL_MEAS e REG_CONFIG (datasheet, seções 3.3 a 3.6)
+// Mais sobreamostragem e filtro reduzem o ruído; custam tempo de conversão e consumo
+enum bmp280_oversampling {
+    BMP280_OSRS_SKIP, BMP280_OSRS_X1, BMP280_OSRS_X2, BMP280_OSRS_X4, BMP280_OSRS_X8, BMP280_OSRS_X16
+};
+
+enum bmp280_filter {
+    BMP280_FILTER_OFF, BMP280_FILTER_2, BMP280_FILTER_4, BMP280_FILTER_8, BMP280_FILTER_16
+};
+
+enum bmp280_standby {
+    BMP280_STANDBY_0_5_MS, BMP280_STANDBY_62_5_MS, BMP280_STANDBY_125_MS, BMP280_STANDBY_250_MS,
+    BMP280_STANDBY_500_MS, BMP280_STANDBY_1000_MS, BMP280_STANDBY_2000_MS, BMP280_STANDBY_4000_MS
+};
+
+struct bmp280_config {
+    uint8_t osrs_t;      // enum bmp280_oversampling (temperatura; SKIP impede compensar a pressão)
+    uint8_t osrs_p;      // enum bmp280_oversampling (pressão)
+    uint8_t filter;      // enum bmp280_filter
+    uint8_t standby;     // enum bmp280_standby
+};
+
+// Configuração usada por bmp280_init: pressão x4, temperatura x1, filtro 16, 500 ms
+#define BMP280_CONFIG_DEFAULT { BMP280_OSRS_X1, BMP280_OSRS_X4, BMP280_FILTER_16, BMP280_STANDBY_500_MS }
+
+/* ---------- Leitura em Rajada ---------- */
+struct bmp280_reading {
+    int32_t temp;        // Temperatura bruta (20 bits)
+    int32_t pressure;    // Pressão bruta (20 bits)
+    bool fresh;          // Resultado de uma conversão que ainda não tinha sido lida
+    bool measuring;      // Bit MEASURING visto nesta leitura
+    uint64_t fresh_us;   // Quando o último resultado novo foi entregue (0 = nenhum)
 };
 
 /* ---------- API do Sensor BMP280 ---------- */
 
-// Inicializa o sensor BMP280
+// Inicializa o sensor BMP280 em modo normal com BMP280_CONFIG_DEFAULT
 void bmp280_init(i2c_inst_t *i2c);
 
-// Lê dados brutos de temperatura e pressão
-void bmp280_read_raw(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure);
+// Aplica sobreamostragem, filtro e pausa e coloca o sensor em modo normal
+// Passa pelo modo sleep antes: em modo normal a escrita em REG_CONFIG pode ser ignorada
+bool bmp280_configure(i2c_inst_t *i2c, const struct bmp280_config *config);
+
+// Tempo máximo de uma conversão e intervalo entre resultados em modo normal (datasheet, seção 3.8)
+uint32_t bmp280_measurement_time_us(const struct bmp280_config *config);
+uint32_t bmp280_cycle_time_us(const struct bmp280_config *config);
+
+// Lê status, controle e dados numa só transação (0xF3 a 0xFC)
+// O sensor trava os registros de dados durante a rajada, então temperatura e
+// pressão vêm sempre da mesma conversão, mesmo com outra em andamento
+// 'reading' deve guardar a leitura anterior: 'fresh' vem do status e do tempo.
+// O resultado é novo se o bit MEASURING caiu desde a leitura anterior, se já passou
+// um ciclo inteiro de conversão (da configuração lida na rajada) desde o último
+// resultado novo, ou, por último, se os valores brutos mudaram
+// Retorna false (sem alterar 'reading') se o sensor não respondeu, está copiando
+// a calibração, ainda não converteu nada ou saiu do modo normal (ex.: após reset)
+bool bmp280_read_burst(i2c_inst_t *i2c, struct bmp280_reading *reading);
 
 // Reseta o sensor BMP280
 void bmp280_reset(i2c_inst_t *i2c);
@@ -84,10 +128,4 @@ void bmp280_reset(i2c_inst_t *i2c);
 // Obtém parâmetros de calibração do sensor
 void bmp280_get_calib_params(i2c_inst_t *i2c, struct bmp280_calib_param* params);
 
-// Converte temperatura bruta para valor calibrado
-int32_t bmp280_convert_temp(int32_t temp, struct bmp280_calib_param* params);
-
-// Converte pressão bruta para valor calibrado
-int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_calib_param* params);
-
 #endif
@@ -0,0 +1,150 @@
+#include "bmp280_compensacao.h"
+
+/* ---------- Funções Internas ---------- */
+
+// Temperatura de resolução fina, usada tanto para a temperatura quanto para a pressão
+static int32_t calcular_t_fine(int32_t temp, const struct bmp280_calib_param *params) {
+    // Usa compensação de ponto fixo de 32 bits implementada no datasheet
+    int32_t var1, var2;
+
+    var1 = ((((temp >> 3) - ((int32_t)params->dig_t1 << 1))) *
+            ((int32_t)params->dig_t2)) >> 11;
+
+    var2 = (((((temp >> 4) - ((int32_t)params->dig_t1)) *
+             ((temp >> 4) - ((int32_t)params->dig_t1))) >> 12) *
+            ((int32_t)params->dig_t3)) >> 14;
+
+    return var1 + var2;
+}
+
+static inline int32_t temperatura_de_t_fine(int32_t t_fine) {
+    return (t_fine * 5 + 128) >> 8;
+}
+
+#if BMP280_PRESSURE_64BIT
+
+// Coeficientes da pressão que só dependem de t_fine
+typedef struct {
+    int64_t divisor;
+    int64_t deslocamento;
+} coeficientes_pressao_t;
+
+static void calcular_coeficientes(int32_t t_fine, const struct bmp280_calib_param *params, coeficientes_pressao_t *c) {
+    int64_t var1, var2;
+
+    var1 = ((int64_t)t_fine) - 128000;
+    var2 = var1 * var1 * (int64_t)params->dig_p6;
+    var2 = var2 + var1 * (int64_t)params->dig_p5 * 131072;   // << 17 no datasheet (var1 pode ser negativo)
+    var2 = var2 + (((int64_t)params->dig_p4) << 35);
+    var1 = ((var1 * var1 * (int64_t)params->dig_p3) >> 8) + var1 * (int64_t)params->dig_p2 * 4096;
+    var1 = (((((int64_t)1) << 47) + var1)) * ((int64_t)params->dig_p1) >> 33;
+
+    c->divisor = var1;
+    c->deslocamento = var2;
+}
+
+// Pressão em Pa Q24.8
+static int32_t aplicar_coeficientes(int32_t pressure, const struct bmp280_calib_param *params, const coeficientes_pressao_t *c) {
+    if (c->divisor == 0) {
+        return 0;  // Evita exceção causada por divisão por zero
+    }
+
+    int64_t p = 1048576 - pressure;
+    p = (((p << 31) - c->deslocamento) * 3125) / c->divisor;
+    int64_t var1 = (((int64_t)params->dig_p9) * (p >> 13) * (p >> 13)) >> 25;
+    int64_t var2 = (((int64_t)params->dig_p8) * p) >> 19;
+    p = ((p + var1 + var2) >> 8) + (((int64_t)params->dig_p7) << 4);
+
+    return (int32_t)p;
+}
+
+#else
+
+// Coeficientes da pressão que só dependem de t_fine
+typedef struct {
+    uint32_t divisor;
+    int32_t deslocamento;
+} coeficientes_pressao_t;
+
+static void calcular_coeficientes(int32_t t_fine, const struct bmp280_calib_param *params, coeficientes_pressao_t *c) {
+    int32_t var1, var2;
+
+    var1 = (((int32_t)t_fine) >> 1) - (int32_t)64000;
+    var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * ((int32_t)params->dig_p6);
+    var2 += var1 * ((int32_t)params->dig_p5) * 2;              // << 1 no datasheet (var1 pode ser negativo)
+    var2 = (var2 >> 2) + (((int32_t)params->dig_p4) << 16);
+
+    var1 = (((params->dig_p3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) +
+            ((((int32_t)params->dig_p2) * var1) >> 1)) >> 18;
+    var1 = ((((32768 + var1)) * ((int32_t)params->dig_p1)) >> 15);
+
+    c->divisor = (uint32_t)var1;
+    c->deslocamento = var2 >> 12;
+}
+
+// Pressão em Pa Q24.8 (a fração é sempre zero neste caminho)
+static int32_t aplicar_coeficientes(int32_t pressure, const struct bmp280_calib_param *params, const coeficientes_pressao_t *c) {
+    if (c->divisor == 0) {
+        return 0;  // Evita exceção causada por divisão por zero
+    }
+
+    uint32_t converted = (((uint32_t)(((int32_t)1048576) - pressure) - c->deslocamento)) * 3125;
+
+    if (converted < 0x80000000) {
+        converted = (converted << 1) / c->divisor;
+    } else {
+        converted = (converted / c->divisor) * 2;
+    }
+
+    int32_t var1 = (((int32_t)params->dig_p9) *
+                    ((int32_t)(((converted >> 3) * (converted >> 3)) >> 13))) >> 12;
+    int32_t var2 = (((int32_t)(converted >> 2)) * ((int32_t)params->dig_p8)) >> 13;
+    converted = (uint32_t)((int32_t)converted + ((var1 + var2 + params->dig_p7) >> 4));
+
+    return (int32_t)(converted << BMP280_PRESSURE_FRAC_BITS);
+}
+
+#endif // BMP280_PRESSURE_64BIT
+
+/* ---------- Funções Públicas ---------- */
+
+void bmp280_compensate(int32_t raw_t, int32_t raw_p, const struct bmp280_calib_param *params,
+                       int32_t *temp, int32_t *pressure) {
+    int32_t t_fine = calcular_t_fine(raw_t, params);
+    coeficientes_pressao_t c;
+    calcular_coeficientes(t_fine, params, &c);
+
+    *temp = temperatura_de_t_fine(t_fine);
+    *pressure = aplicar_coeficientes(raw_p, params, &c);
+}
+
+void bmp280_compensate_batch(const int32_t *raw_t, const int32_t *raw_p, size_t n,
+                             const struct bmp280_calib_param *params, int32_t *temp, int32_t *pressure) {
+    coeficientes_pressao_t c;
+    int32_t anterior = 0, t = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        // Lê as entradas antes de escrever: as saídas podem ocupar os mesmos vetores
+        int32_t bruta_t = raw_t[i], bruta_p = raw_p[i];
+        if (i == 0 || bruta_t != anterior) {
+            int32_t t_fine = calcular_t_fine(bruta_t, params);
+            calcular_coeficientes(t_fine, params, &c);
+            t = temperatura_de_t_fine(t_fine);
+            anterior = bruta_t;
+        }
+        temp[i] = t;
+        pressure[i] = aplicar_coeficientes(bruta_p, params, &c);
+    }
+}
+
+int32_t bmp280_convert_temp(int32_t temp, struct bmp280_calib_param* params) {
+    // Utiliza parâmetros de calibração do BMP280 para compensar valor de temperatura
+    return temperatura_de_t_fine(calcular_t_fine(temp, params));
+}
+
+int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_calib_param* params) {
+    // Utiliza parâmetros de calibração do BMP280 para compensar valor de pressão
+    int32_t t, p;
+    bmp280_compensate(temp, pressure, params, &t, &p);
+    return (p + (1 << (BMP280_PRESSURE_FRAC_BITS - 1))) >> BMP280_PRESSURE_FRAC_BITS;
+}
@@ -0,0 +1,64 @@
+#ifndef BMP280_COMPENSACAO_H
+#define BMP280_COMPENSACAO_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ---------- Compensação do BMP280 ---------- */
+// Converte as leituras brutas (20 bits) em temperatura e pressão com os
+// parâmetros de calibração gravados no sensor, pelas fórmulas em ponto fixo
+// do datasheet (seção 3.11.3). Não depende do SDK: roda igual no PC.
+//
+// A pressão depende da temperatura através de t_fine, e quase todo o custo
+// do cálculo da pressão está nos coeficientes que só dependem de t_fine.
+// bmp280_compensate() calcula t_fine uma vez para os dois valores; o lote
+// (bmp280_compensate_batch) ainda reaproveita os coeficientes enquanto a
+// temperatura bruta se repete, o caso comum em leituras em rajada.
+
+// Caminho da pressão: 0 = inteiro de 32 bits do datasheet (resolução de 1 Pa,
+// erro de alguns Pa); 1 = inteiro de 64 bits (1/256 Pa), mais exato e mais
+// lento no Cortex-M0+, que não tem multiplicação nem divisão de 64 bits
+#ifndef BMP280_PRESSURE_64BIT
+#define BMP280_PRESSURE_64BIT 0
+#endif
+
+// Pressão compensada em Pa com 8 bits de fração (Q24.8) nos dois caminhos
+#define BMP280_PRESSURE_FRAC_BITS 8
+
+/* ---------- Estrutura de Parâmetros de Calibração ---------- */
+struct bmp280_calib_param {
+    // Parâmetros de calibração de temperatura
+    uint16_t dig_t1;
+    int16_t dig_t2;
+    int16_t dig_t3;
+
+    // Parâmetros de calibração de pressão
+    uint16_t dig_p1;
+    int16_t dig_p2;
+    int16_t dig_p3;
+    int16_t dig_p4;
+    int16_t dig_p5;
+    int16_t dig_p6;
+    int16_t dig_p7;
+    int16_t dig_p8;
+    int16_t dig_p9;
+};
+
+/* ---------- API da Compensação ---------- */
+
+// Temperatura em centésimos de °C e pressão em Pa Q24.8 de uma amostra
+// A pressão é 0 se os parâmetros forem inválidos (divisor nulo)
+void bmp280_compensate(int32_t raw_t, int32_t raw_p, const struct bmp280_calib_param *params,
+                       int32_t *temp, int32_t *pressure);
+
+// O mesmo para 'n' amostras; as saídas podem ser as próprias entradas
+void bmp280_compensate_batch(const int32_t *raw_t, const int32_t *raw_p, size_t n,
+                             const struct bmp280_calib_param *params, int32_t *temp, int32_t *pressure);
+
+// Converte temperatura bruta para valor calibrado (centésimos de °C)
+int32_t bmp280_convert_temp(int32_t temp, struct bmp280_calib_param* params);
+
+// Converte pressão bruta para valor calibrado (Pa); calcula t_fine de novo
+int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_calib_param* params);
+
+#endif // BMP280_COMPENSACAO_H
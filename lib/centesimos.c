@@ -0,0 +1,25 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include "centesimos.h"
+
+/* ---------- Funções Públicas ---------- */
+
+size_t centesimos_formatar(char *destino, size_t capacidade, int32_t valor, uint8_t casas) {
+    static const uint32_t DIVISOR[] = {100, 10, 1};   // Centésimos por passo da última casa
+    if (casas > 2) casas = 2;
+
+    uint32_t divisor = DIVISOR[casas];
+    uint32_t magnitude = valor < 0 ? 0u - (uint32_t)valor : (uint32_t)valor;
+    magnitude = (magnitude + divisor / 2) / divisor;          // Arredonda na última casa
+    bool negativo = valor < 0 && magnitude != 0;               // Sem "-0.0"
+
+    int n;
+    if (casas == 0) {
+        n = snprintf(destino, capacidade, "%s%lu", negativo ? "-" : "", (unsigned long)magnitude);
+    } else {
+        uint32_t escala = CENTESIMOS / divisor;
+        n = snprintf(destino, capacidade, "%s%lu.%0*lu", negativo ? "-" : "",
+                     (unsigned long)(magnitude / escala), (int)casas, (unsigned long)(magnitude % escala));
+    }
+    return (n < 0 || (size_t)n >= capacidade) ? 0 : (size_t)n;
+}
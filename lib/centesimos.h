@@ -0,0 +1,52 @@
+#ifndef CENTESIMOS_H
+#define CENTESIMOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ---------- Grandezas em Centésimos ---------- */
+// Temperatura, umidade e pressão circulam pelo firmware como inteiros em
+// centésimos da unidade exibida, dos drivers até a formatação:
+//   temperatura: centésimos de °C  (2508 = 25,08 °C, como o BMP280 já entrega)
+//   umidade:     centésimos de %   (4512 = 45,12 %)
+//   pressão:     centésimos de hPa (101325 = 1013,25 hPa), ou seja, Pa
+//
+// O RP2040 não tem FPU: cada soma, comparação ou divisão em float é uma
+// rotina em software. Em centésimos, calibração, médias, limites, históricos
+// e gráficos são operações inteiras, e o JSON sai com json_fixo(valor, 2).
+// float só aparece nas bordas: os números digitados na configuração e o
+// formato binário de telemetria.h.
+//
+// As faixas dos sensores cabem com folga em int32_t; uma soma de muitas
+// leituras (agregado_t) usa int64_t.
+
+#define CENTESIMOS 100               // Centésimos por unidade
+
+/* ---------- Bordas ---------- */
+
+// Número digitado (configuração) para centésimos, arredondado
+static inline int32_t centesimos_de_real(float valor) {
+    return (int32_t)(valor * CENTESIMOS + (valor < 0.0f ? -0.5f : 0.5f));
+}
+
+// Centésimos para float (telemetria binária)
+static inline float centesimos_para_real(int32_t valor) {
+    return (float)valor / CENTESIMOS;
+}
+
+/* ---------- Aritmética ---------- */
+
+// Divisão arredondada, com o empate se afastando do zero; 'divisor' > 0
+static inline int32_t centesimos_dividir(int64_t valor, int32_t divisor) {
+    int64_t metade = divisor / 2;
+    return (int32_t)((valor < 0 ? valor - metade : valor + metade) / divisor);
+}
+
+/* ---------- Formatação ---------- */
+
+// Escreve o valor com 0, 1 ou 2 casas decimais ("25.1" para 2508 com 1 casa), sem
+// printf de float; arredonda na última casa, com o empate se afastando do zero
+// Retorna o tamanho escrito (sem o '\0') ou 0 se não couber
+size_t centesimos_formatar(char *destino, size_t capacidade, int32_t valor, uint8_t casas);
+
+#endif // CENTESIMOS_H
@@ -0,0 +1,283 @@
+#include <string.h>
+#include "pico/sync.h"
+#include "configuracao.h"
+#include "leitor_json.h"
+
+/* ---------- Tabela Gerada ---------- */
+
+const campo_config_t CAMPOS_CONFIG[] = {
+#define CONFIG_DESCRITOR(nome, tipo, minimo, maximo, padrao, unidade) \
+    {#nome, unidade, offsetof(configuracao_t, nome), CONFIG_##tipo, minimo, maximo, padrao},
+    CAMPOS_CONFIGURACAO(CONFIG_DESCRITOR)
+#undef CONFIG_DESCRITOR
+};
+const uint8_t NUM_CAMPOS_CONFIG = sizeof(CAMPOS_CONFIG) / sizeof(CAMPOS_CONFIG[0]);
+
+configuracao_t config_atual = {
+#define CONFIG_PADRAO(nome, tipo, minimo, maximo, padrao, unidade) .nome = CONFIG_VALOR_C_##tipo(padrao),
+    CAMPOS_CONFIGURACAO(CONFIG_PADRAO)
+#undef CONFIG_PADRAO
+};
+uint32_t versao_config = 0;
+
+// Protege config_atual entre os núcleos e contra os callbacks do lwIP
+static critical_section_t secao_config;
+
+// Pares (mínimo, máximo) que precisam ficar em ordem (campos CENTESIMOS)
+#define LIMITE_ORDENADO(min, max) {offsetof(configuracao_t, min), offsetof(configuracao_t, max), #min}
+static const struct {
+    uint16_t minimo, maximo;
+    const char *nome;        // Campo apontado no erro
+} LIMITES_ORDENADOS[] = {
+    LIMITE_ORDENADO(temp_min, temp_max),
+    LIMITE_ORDENADO(umid_min, umid_max),
+    LIMITE_ORDENADO(press_min, press_max),
+};
+
+/* ---------- Funções Internas ---------- */
+
+static float *membro_real(configuracao_t *c, uint16_t deslocamento) {
+    return (float *)((uint8_t *)c + deslocamento);
+}
+
+static float ler_real(const configuracao_t *c, uint16_t deslocamento) {
+    return *(const float *)((const uint8_t *)c + deslocamento);
+}
+
+static int32_t *membro_inteiro(configuracao_t *c, uint16_t deslocamento) {
+    return (int32_t *)((uint8_t *)c + deslocamento);
+}
+
+static int32_t ler_inteiro(const configuracao_t *c, uint16_t deslocamento) {
+    return *(const int32_t *)((const uint8_t *)c + deslocamento);
+}
+
+// Valor de qualquer campo como float, na unidade da tabela (inteiros da tabela são pequenos e exatos)
+static float ler_campo(const configuracao_t *c, const campo_config_t *campo) {
+    switch (campo->tipo) {
+        case CONFIG_INTEIRO:    return (float)ler_inteiro(c, campo->deslocamento);
+        case CONFIG_CENTESIMOS: return centesimos_para_real(ler_inteiro(c, campo->deslocamento));
+        default:                return ler_real(c, campo->deslocamento);
+    }
+}
+
+// Guarda o valor no tipo do campo; false se um campo INTEIRO recebeu valor fracionário
+static bool escrever_campo(configuracao_t *c, const campo_config_t *campo, float valor) {
+    if (campo->tipo == CONFIG_INTEIRO) {
+        if (valor != (float)(int32_t)valor) return false;
+        *membro_inteiro(c, campo->deslocamento) = (int32_t)valor;
+    } else if (campo->tipo == CONFIG_CENTESIMOS) {
+        *membro_inteiro(c, campo->deslocamento) = centesimos_de_real(valor);
+    } else {
+        *membro_real(c, campo->deslocamento) = valor;
+    }
+    return true;
+}
+
+// Número no JSON com a apresentação do tipo do campo
+static void escrever_numero(escritor_json_t *j, const campo_config_t *campo, float valor) {
+    if (campo->tipo == CONFIG_INTEIRO) json_inteiro(j, (int32_t)valor);
+    else                               json_real(j, valor, 2);
+}
+
+// Identificador de um campo no formato gravado: FNV-1a de 32 bits do nome
+static uint32_t identificador_campo(const char *nome) {
+    uint32_t hash = 2166136261u;
+    while (*nome) {
+        hash ^= (uint8_t)*nome++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static const campo_config_t *buscar_campo(const char *nome, size_t tamanho) {
+    for (uint8_t i = 0; i < NUM_CAMPOS_CONFIG; i++) {
+        if (strncmp(CAMPOS_CONFIG[i].nome, nome, tamanho) == 0 && CAMPOS_CONFIG[i].nome[tamanho] == '\0') {
+            return &CAMPOS_CONFIG[i];
+        }
+    }
+    return NULL;
+}
+
+static bool falhar(erro_config_t *erro, resultado_config_t resultado, const char *campo, size_t tamanho) {
+    erro->resultado = resultado;
+    if (tamanho >= sizeof(erro->campo)) tamanho = sizeof(erro->campo) - 1;
+    memcpy(erro->campo, campo, tamanho);
+    erro->campo[tamanho] = '\0';
+    return false;
+}
+
+// Guarda o valor no campo se ele estiver dentro da faixa da tabela
+static bool alterar_campo(configuracao_t *c, const char *nome, size_t tam_nome, float valor, erro_config_t *erro) {
+    const campo_config_t *campo = buscar_campo(nome, tam_nome);
+    if (!campo) return falhar(erro, CONFIG_CAMPO_DESCONHECIDO, nome, tam_nome);
+    if (!(valor >= campo->minimo && valor <= campo->maximo)) {
+        return falhar(erro, CONFIG_FORA_DA_FAIXA, nome, tam_nome);
+    }
+    if (!escrever_campo(c, campo, valor)) return falhar(erro, CONFIG_VALOR_INVALIDO, nome, tam_nome);
+    return true;
+}
+
+/* ---------- Funções Públicas ---------- */
+
+void config_escrever_valores(escritor_json_t *j, const configuracao_t *c) {
+    for (uint8_t i = 0; i < NUM_CAMPOS_CONFIG; i++) {
+        const campo_config_t *campo = &CAMPOS_CONFIG[i];
+        json_chave(j, campo->nome);
+        // Centésimos saem direto, sem passar por float (vai em cada /dados)
+        if (campo->tipo == CONFIG_CENTESIMOS) json_fixo(j, ler_inteiro(c, campo->deslocamento), 2);
+        else                                  escrever_numero(j, campo, ler_campo(c, campo));
+    }
+}
+
+void config_escrever_esquema(escritor_json_t *j) {
+    for (uint8_t i = 0; i < NUM_CAMPOS_CONFIG; i++) {
+        const campo_config_t *campo = &CAMPOS_CONFIG[i];
+        json_chave(j, campo->nome);
+        json_abrir_objeto(j);
+        json_chave(j, "tipo");
+        json_texto(j, campo->tipo == CONFIG_INTEIRO ? "inteiro" : "real");
+        json_chave(j, "min");
+        escrever_numero(j, campo, campo->minimo);
+        json_chave(j, "max");
+        escrever_numero(j, campo, campo->maximo);
+        json_chave(j, "padrao");
+        escrever_numero(j, campo, campo->padrao);
+        json_chave(j, "unidade");
+        json_texto(j, campo->unidade);
+        json_fechar_objeto(j);
+    }
+}
+
+bool config_ler_json(configuracao_t *c, const char *json, size_t tamanho, erro_config_t *erro) {
+    leitor_json_t l;
+    if (!leitor_json_iniciar(&l, json, tamanho)) return falhar(erro, CONFIG_FORMATO_INVALIDO, "", 0);
+
+    char chave[CONFIG_TAM_NOME];
+    float valor;
+    for (;;) {
+        switch (leitor_json_proximo(&l, chave, sizeof(chave), &valor)) {
+            case LEITURA_JSON_FIM:
+                erro->resultado = CONFIG_OK;
+                erro->campo[0] = '\0';
+                return true;
+            case LEITURA_JSON_NAO_NUMERO:
+                return falhar(erro, CONFIG_VALOR_INVALIDO, chave, strlen(chave));
+            case LEITURA_JSON_ERRO:
+                return falhar(erro, CONFIG_FORMATO_INVALIDO, "", 0);
+            case LEITURA_JSON_MEMBRO:
+                break;
+        }
+        if (strcmp(chave, "versao") == 0) {
+            if (valor != (float)versao_config) return falhar(erro, CONFIG_VERSAO_DIVERGENTE, "versao", 6);
+            continue;
+        }
+        if (!alterar_campo(c, chave, strlen(chave), valor, erro)) return false;
+    }
+}
+
+bool config_ler_query(configuracao_t *c, const char *query, erro_config_t *erro) {
+    while (*query) {
+        const char *fim = query + strcspn(query, "&");
+        const char *igual = memchr(query, '=', (size_t)(fim - query));
+        if (!igual) return falhar(erro, CONFIG_FORMATO_INVALIDO, query, (size_t)(fim - query));
+
+        float valor;
+        size_t tam_nome = (size_t)(igual - query);
+        if (!json_ler_numero(igual + 1, (size_t)(fim - igual - 1), &valor)) {
+            return falhar(erro, CONFIG_VALOR_INVALIDO, query, tam_nome);
+        }
+        if (!alterar_campo(c, query, tam_nome, valor, erro)) return false;
+        query = (*fim == '&') ? fim + 1 : fim;
+    }
+    erro->resultado = CONFIG_OK;
+    erro->campo[0] = '\0';
+    return true;
+}
+
+bool config_validar(const configuracao_t *c, erro_config_t *erro) {
+    for (uint8_t i = 0; i < NUM_CAMPOS_CONFIG; i++) {
+        const campo_config_t *campo = &CAMPOS_CONFIG[i];
+        float valor = ler_campo(c, campo);
+        if (!(valor >= campo->minimo && valor <= campo->maximo)) {
+            return falhar(erro, CONFIG_FORA_DA_FAIXA, campo->nome, strlen(campo->nome));
+        }
+    }
+    for (size_t i = 0; i < sizeof(LIMITES_ORDENADOS) / sizeof(LIMITES_ORDENADOS[0]); i++) {
+        if (ler_inteiro(c, LIMITES_ORDENADOS[i].minimo) >= ler_inteiro(c, LIMITES_ORDENADOS[i].maximo)) {
+            const char *nome = LIMITES_ORDENADOS[i].nome;
+            return falhar(erro, CONFIG_LIMITES_INVERTIDOS, nome, strlen(nome));
+        }
+    }
+    erro->resultado = CONFIG_OK;
+    erro->campo[0] = '\0';
+    return true;
+}
+
+void config_iniciar(void) {
+    critical_section_init(&secao_config);
+}
+
+void config_copiar(configuracao_t *destino) {
+    critical_section_enter_blocking(&secao_config);
+    *destino = config_atual;
+    critical_section_exit(&secao_config);
+}
+
+void config_aplicar(const configuracao_t *nova) {
+    critical_section_enter_blocking(&secao_config);
+    config_atual = *nova;
+    versao_config++;
+    critical_section_exit(&secao_config);
+}
+
+void config_restaurar(const configuracao_t *salva, uint32_t versao) {
+    critical_section_enter_blocking(&secao_config);
+    config_atual = *salva;
+    versao_config = versao;
+    critical_section_exit(&secao_config);
+}
+
+size_t config_serializar(const configuracao_t *c, uint32_t versao, uint8_t *destino, size_t capacidade) {
+    size_t tamanho = 4 + 8 * (size_t)NUM_CAMPOS_CONFIG;
+    if (capacidade < tamanho) return 0;
+    memcpy(destino, &versao, 4);
+    for (uint8_t i = 0; i < NUM_CAMPOS_CONFIG; i++) {
+        uint32_t id = identificador_campo(CAMPOS_CONFIG[i].nome);
+        float valor = ler_campo(c, &CAMPOS_CONFIG[i]);
+        memcpy(destino + 4 + 8 * i, &id, 4);
+        memcpy(destino + 8 + 8 * i, &valor, 4);
+    }
+    return tamanho;
+}
+
+bool config_desserializar(configuracao_t *c, uint32_t *versao, const uint8_t *dados, size_t tamanho) {
+    if (tamanho < 4 || (tamanho - 4) % 8 != 0) return false;
+    memcpy(versao, dados, 4);
+    for (size_t par = 4; par < tamanho; par += 8) {
+        uint32_t id;
+        float valor;
+        memcpy(&id, dados + par, 4);
+        memcpy(&valor, dados + par + 4, 4);
+        for (uint8_t i = 0; i < NUM_CAMPOS_CONFIG; i++) {
+            const campo_config_t *campo = &CAMPOS_CONFIG[i];
+            if (identificador_campo(campo->nome) != id) continue;
+            if (valor >= campo->minimo && valor <= campo->maximo) escrever_campo(c, campo, valor);
+            break;
+        }
+    }
+    return true;
+}
+
+const char *config_descrever(resultado_config_t resultado) {
+    switch (resultado) {
+        case CONFIG_OK:                 return "ok";
+        case CONFIG_FORMATO_INVALIDO:   return "formato invalido";
+        case CONFIG_CAMPO_DESCONHECIDO: return "campo desconhecido";
+        case CONFIG_VALOR_INVALIDO:     return "valor nao numerico";
+        case CONFIG_FORA_DA_FAIXA:      return "fora da faixa";
+        case CONFIG_LIMITES_INVERTIDOS: return "minimo deve ser menor que o maximo";
+        case CONFIG_VERSAO_DIVERGENTE:  return "versao desatualizada";
+    }
+    return "erro";
+}
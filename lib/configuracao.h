@@ -0,0 +1,160 @@
+#ifndef CONFIGURACAO_H
+#define CONFIGURACAO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "escritor_json.h"
+#include "centesimos.h"
+
+/* ---------- Campos Configuráveis ---------- */
+// Tabela única da configuração do sistema: a estrutura, os valores padrão,
+// a validação, o JSON de /config e /dados e a leitura de alterações são
+// todos gerados a partir dela. Um campo novo é uma linha nova aqui.
+//
+//   X(nome, tipo, mínimo, máximo, padrão, unidade)
+//
+// 'nome' é ao mesmo tempo o membro de configuracao_t e a chave no JSON e na
+// query string. Tipos: REAL (float), INTEIRO (int32_t, só aceita valores inteiros) e
+// CENTESIMOS (int32_t em centésimos da unidade, lib/centesimos.h: 20,5 °C fica 2050).
+// Num campo CENTESIMOS, mínimo, máximo e padrão continuam na unidade, e um número
+// com mais de duas casas é arredondado. No JSON e na flash o valor continua na
+// unidade, como num campo REAL: configurações já gravadas valem sem conversão
+//
+// Os campos bmp_* são os códigos dos registros do BMP280 (lib/bmp280.h):
+//   bmp_osrs_t, bmp_osrs_p: sobreamostragem 1..5 = x1, x2, x4, x8, x16
+//   bmp_filtro:             filtro IIR 0..4 = desligado, 2, 4, 8, 16
+//   bmp_standby:            pausa entre conversões 0..7 = 0,5, 62,5, 125, 250, 500, 1000, 2000, 4000 ms
+//
+// taxa_bmp_hz: leituras do BMP280 por segundo entre as coletas, resumidas em mínimo,
+// máximo e média de cada intervalo (0 = uma leitura por coleta). Só conversões novas
+// entram no resumo: a pausa (bmp_standby) e o filtro limitam o que se vê de fato
+
+#define CAMPOS_CONFIGURACAO(X) \
+    X(temp_min,        CENTESIMOS, -40.0f,   85.0f,   20.0f, "°C")  \
+    X(temp_max,        CENTESIMOS, -40.0f,   85.0f,   30.0f, "°C")  \
+    X(umid_min,        CENTESIMOS,   0.0f,  100.0f,   40.0f, "%")   \
+    X(umid_max,        CENTESIMOS,   0.0f,  100.0f,   80.0f, "%")   \
+    X(press_min,       CENTESIMOS, 300.0f, 1100.0f,  900.0f, "hPa") \
+    X(press_max,       CENTESIMOS, 300.0f, 1100.0f, 1000.0f, "hPa") \
+    X(offset_temp_aht, CENTESIMOS, -10.0f,   10.0f,    0.0f, "°C")  \
+    X(offset_temp_bmp, CENTESIMOS, -10.0f,   10.0f,    0.0f, "°C")  \
+    X(offset_umid,     CENTESIMOS, -20.0f,   20.0f,    0.0f, "%")   \
+    X(offset_press,    CENTESIMOS, -50.0f,   50.0f,    0.0f, "hPa") \
+    X(bmp_osrs_t,      INTEIRO,      1.0f,    5.0f,    1.0f, "")    \
+    X(bmp_osrs_p,      INTEIRO,      1.0f,    5.0f,    3.0f, "")    \
+    X(bmp_filtro,      INTEIRO,      0.0f,    4.0f,    4.0f, "")    \
+    X(bmp_standby,     INTEIRO,      0.0f,    7.0f,    1.0f, "")    \
+    X(taxa_bmp_hz,     INTEIRO,      0.0f,   50.0f,   10.0f, "Hz")
+
+// Tipo C de cada tipo da tabela
+#define CONFIG_TIPO_C_REAL       float
+#define CONFIG_TIPO_C_INTEIRO    int32_t
+#define CONFIG_TIPO_C_CENTESIMOS int32_t
+
+// Valor da tabela (mínimo, máximo, padrão) guardado no tipo C do campo
+#define CONFIG_VALOR_C_REAL(x)       (x)
+#define CONFIG_VALOR_C_INTEIRO(x)    ((int32_t)(x))
+#define CONFIG_VALOR_C_CENTESIMOS(x) ((int32_t)((x) * CENTESIMOS + ((x) < 0 ? -0.5f : 0.5f)))
+
+typedef struct {
+#define CONFIG_MEMBRO(nome, tipo, minimo, maximo, padrao, unidade) CONFIG_TIPO_C_##tipo nome;
+    CAMPOS_CONFIGURACAO(CONFIG_MEMBRO)
+#undef CONFIG_MEMBRO
+} configuracao_t;
+
+/* ---------- Descrição dos Campos ---------- */
+typedef enum {
+    CONFIG_REAL,
+    CONFIG_INTEIRO,
+    CONFIG_CENTESIMOS
+} tipo_config_t;
+
+typedef struct {
+    const char *nome;
+    const char *unidade;
+    uint16_t deslocamento;   // Posição do membro em configuracao_t
+    tipo_config_t tipo;
+    float minimo, maximo, padrao;
+} campo_config_t;
+
+extern const campo_config_t CAMPOS_CONFIG[];
+extern const uint8_t NUM_CAMPOS_CONFIG;
+
+// Número de campos como constante de compilação (tamanho de buffers)
+#define CONFIG_CONTAR(nome, tipo, minimo, maximo, padrao, unidade) + 1
+#define CONFIG_NUM_CAMPOS (0 CAMPOS_CONFIGURACAO(CONFIG_CONTAR))
+
+// Formato gravado na flash: versão (4 bytes) e um par (identificador, valor) de
+// 8 bytes por campo. O identificador é um hash do nome: campos acrescentados,
+// removidos ou reordenados em outra versão do firmware não trocam de valor
+#define CONFIG_TAM_SERIALIZADA (4 + 8 * CONFIG_NUM_CAMPOS)
+
+/* ---------- Resultado de uma Alteração ---------- */
+typedef enum {
+    CONFIG_OK,
+    CONFIG_FORMATO_INVALIDO,     // Não é um objeto JSON (ou query) de números
+    CONFIG_CAMPO_DESCONHECIDO,
+    CONFIG_VALOR_INVALIDO,       // Valor não é um número (ou não é inteiro num campo INTEIRO)
+    CONFIG_FORA_DA_FAIXA,
+    CONFIG_LIMITES_INVERTIDOS,   // Um limite mínimo não ficou abaixo do máximo
+    CONFIG_VERSAO_DIVERGENTE     // "versao" enviada não é a atual: outra alteração veio antes
+} resultado_config_t;
+
+#define CONFIG_TAM_NOME 24       // Maior nome de campo, com o '\0'
+
+typedef struct {
+    resultado_config_t resultado;
+    char campo[CONFIG_TAM_NOME]; // Campo que causou o erro (vazio se não se aplica)
+} erro_config_t;
+
+/* ---------- Configuração em Vigor ---------- */
+// Só muda por config_aplicar() (nos callbacks do lwIP) ou config_restaurar(), com a
+// cópia protegida por uma seção crítica. Nos callbacks do lwIP pode ser lida direto;
+// o loop principal e o núcleo 1 leem por config_copiar(), que nunca vê metade de
+// uma alteração
+extern configuracao_t config_atual;
+extern uint32_t versao_config;       // Incrementada a cada alteração aplicada
+
+/* ---------- API da Configuração ---------- */
+
+// Membros "nome": valor de cada campo, na ordem da tabela, no objeto JSON aberto
+void config_escrever_valores(escritor_json_t *j, const configuracao_t *c);
+
+// Membros "nome": {"tipo", "min", "max", "padrao", "unidade"} de cada campo
+void config_escrever_esquema(escritor_json_t *j);
+
+// Altera em 'c' os campos presentes no objeto JSON (os demais ficam como estão)
+// A chave especial "versao", se presente, precisa ser igual a versao_config
+// Só valida cada valor isoladamente; a alteração completa passa por config_validar()
+bool config_ler_json(configuracao_t *c, const char *json, size_t tamanho, erro_config_t *erro);
+
+// O mesmo para uma query string "temp_min=20&temp_max=30"
+bool config_ler_query(configuracao_t *c, const char *query, erro_config_t *erro);
+
+// Confere faixas e a coerência entre campos (mínimos abaixo dos máximos)
+bool config_validar(const configuracao_t *c, erro_config_t *erro);
+
+// Prepara a seção crítica da configuração em vigor; antes de qualquer outra função
+void config_iniciar(void);
+
+// Cópia coerente da configuração em vigor, para quem roda fora dos callbacks do lwIP
+void config_copiar(configuracao_t *destino);
+
+// Torna 'nova' a configuração em vigor e incrementa a versão
+void config_aplicar(const configuracao_t *nova);
+
+// Configuração salva: vale como está, inclusive a versão (usada na inicialização)
+void config_restaurar(const configuracao_t *salva, uint32_t versao);
+
+// Escreve 'c' e 'versao' no formato gravado; retorna o tamanho ou 0 se não couber
+size_t config_serializar(const configuracao_t *c, uint32_t versao, uint8_t *destino, size_t capacidade);
+
+// Lê o formato gravado sobre 'c': campos desconhecidos ou fora da faixa são ignorados
+// e os ausentes ficam como estão; false se os dados estiverem truncados
+bool config_desserializar(configuracao_t *c, uint32_t *versao, const uint8_t *dados, size_t tamanho);
+
+// Mensagem curta para o resultado (para respostas de erro)
+const char *config_descrever(resultado_config_t resultado);
+
+#endif // CONFIGURACAO_H
@@ -0,0 +1,35 @@
+#include "hardware/sync.h"
+#include "fila_amostras.h"
+
+#define MASCARA (FILA_AMOSTRAS_TAM - 1)
+
+_Static_assert((FILA_AMOSTRAS_TAM & MASCARA) == 0, "FILA_AMOSTRAS_TAM precisa ser potência de 2");
+
+/* ---------- Funções Públicas ---------- */
+
+bool fila_amostras_publicar(fila_amostras_t *f, const amostra_sensores_t *a) {
+    uint32_t escrita = f->escrita;
+    if (escrita - f->leitura == FILA_AMOSTRAS_TAM) {
+        f->descartadas++;
+        return false;
+    }
+    // A leitura do índice do consumidor vem antes de sobrescrever a vaga que ele liberou
+    __mem_fence_acquire();
+    f->itens[escrita & MASCARA] = *a;
+    // A amostra fica visível antes do índice que a anuncia
+    __mem_fence_release();
+    f->escrita = escrita + 1;
+    return true;
+}
+
+bool fila_amostras_consumir(fila_amostras_t *f, amostra_sensores_t *a) {
+    uint32_t leitura = f->leitura;
+    if (leitura == f->escrita) return false;
+    // Só lê a amostra depois de ver o índice que a anuncia
+    __mem_fence_acquire();
+    *a = f->itens[leitura & MASCARA];
+    // A cópia termina antes de a vaga voltar para o produtor
+    __mem_fence_release();
+    f->leitura = leitura + 1;
+    return true;
+}
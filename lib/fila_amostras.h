@@ -0,0 +1,81 @@
+#ifndef FILA_AMOSTRAS_H
+#define FILA_AMOSTRAS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "centesimos.h"
+
+/* ---------- Fila de Amostras entre os Núcleos ---------- */
+// Anel de um produtor e um consumidor, sem trava: o núcleo 1 publica as
+// amostras dos sensores e o núcleo 0 as consome. Cada índice só é escrito
+// por um dos lados, e a barreira de memória antes de publicar um índice
+// garante que o outro lado já veja a amostra (ou a vaga) que ele anuncia.
+// Nenhum dos lados espera pelo outro: com a fila cheia, o produtor descarta
+// a amostra nova e conta o descarte.
+//
+// Os índices crescem sem parar (dão a volta em 2^32); a posição no vetor é
+// o índice módulo FILA_AMOSTRAS_TAM, que por isso é potência de 2.
+
+#define FILA_AMOSTRAS_TAM 16         // 32 s de folga a uma amostra a cada 2 s
+
+/* ---------- Agregado de um Intervalo ---------- */
+// Mínimo, máximo e média das leituras feitas dentro de um intervalo de coleta,
+// em centésimos (lib/centesimos.h); a soma em 64 bits não estoura com atrasos longos
+typedef struct {
+    int32_t minimo, maximo;
+    int64_t soma;
+    uint16_t contagem;               // Leituras somadas (0 = nenhuma)
+} agregado_t;
+
+static inline void agregado_zerar(agregado_t *a) {
+    a->minimo = a->maximo = 0;
+    a->soma = 0;
+    a->contagem = 0;
+}
+
+static inline void agregado_incluir(agregado_t *a, int32_t valor) {
+    if (a->contagem == 0 || valor < a->minimo) a->minimo = valor;
+    if (a->contagem == 0 || valor > a->maximo) a->maximo = valor;
+    a->soma += valor;
+    a->contagem++;
+}
+
+// Média arredondada (uma divisão por intervalo, não por leitura)
+static inline int32_t agregado_media(const agregado_t *a) {
+    return a->contagem ? centesimos_dividir(a->soma, a->contagem) : 0;
+}
+
+/* ---------- Amostra ---------- */
+// Uma amostra por intervalo de coleta, em centésimos. temp_bmp e pressao são as
+// médias das leituras do BMP280 no intervalo, e os agregados guardam a faixa delas
+typedef struct {
+    uint64_t instante_us;            // Fim da leitura (time_us_64)
+    uint32_t sequencia;              // Conta as amostras do produtor, inclusive as descartadas
+    int32_t temp_aht, temp_bmp, temp_media;  // Centésimos de °C
+    int32_t umidade;                 // Centésimos de %
+    int32_t pressao;                 // Pa (centésimos de hPa)
+    agregado_t agregado_temp_bmp;    // Centésimos de °C
+    agregado_t agregado_pressao;     // Pa
+} amostra_sensores_t;
+
+typedef struct {
+    amostra_sensores_t itens[FILA_AMOSTRAS_TAM];
+    volatile uint32_t escrita;       // Só o produtor altera
+    volatile uint32_t leitura;       // Só o consumidor altera
+    volatile uint32_t descartadas;   // Só o produtor altera
+} fila_amostras_t;
+
+/* ---------- API da Fila ---------- */
+
+// Produtor: copia a amostra para a fila; false (e conta o descarte) se estiver cheia
+bool fila_amostras_publicar(fila_amostras_t *f, const amostra_sensores_t *a);
+
+// Consumidor: copia a amostra mais antiga para 'a'; false se a fila estiver vazia
+bool fila_amostras_consumir(fila_amostras_t *f, amostra_sensores_t *a);
+
+// Amostras esperando (aproximado se chamada fora dos dois lados)
+static inline uint32_t fila_amostras_ocupacao(const fila_amostras_t *f) {
+    return f->escrita - f->leitura;
+}
+
+#endif // FILA_AMOSTRAS_H
@@ -1,10 +1,23 @@
 #ifndef HTML_H
 #define HTML_H
 
-extern const char HTML_BODY[];          // Página principal com dashboard dos sensores
-extern const char HTML_GRAFICOS[];      // Página de gráficos em tempo real
-extern const char HTML_ESTADOS[];       // Página de monitoramento de status e alertas
-extern const char HTML_LIMITES[];       // Página de configuração de limites dos sensores
-extern const char HTML_CALIBRACAO[];    // Página de calibração com offsets de correção
+#include <stdint.h>
 
-#endif
+/* ---------- Páginas HTML do Sistema PicoAtmos ---------- */
+// As páginas ficam em paginas_web/ e são minificadas e comprimidas com gzip
+// durante o build (ferramentas/gerar_paginas_web.py); o arquivo C gerado
+// define as variáveis abaixo, que o servidor envia com Content-Encoding: gzip
+typedef struct {
+    const uint8_t *dados;       // Conteúdo comprimido (gzip) gravado na flash
+    uint32_t tamanho;           // Tamanho do conteúdo comprimido em bytes
+    uint32_t tamanho_original;  // Tamanho da página minificada, antes do gzip
+    const char *hash;           // Hash do conteúdo (16 dígitos hexadecimais)
+} pagina_web_t;
+
+extern const pagina_web_t HTML_BODY;          // Página principal com dashboard dos sensores
+extern const pagina_web_t HTML_GRAFICOS;      // Página de gráficos em tempo real
+extern const pagina_web_t HTML_ESTADOS;       // Página de monitoramento de status e alertas
+extern const pagina_web_t HTML_LIMITES;       // Página de configuração de limites dos sensores
+extern const pagina_web_t HTML_CALIBRACAO;    // Página de calibração com offsets de correção
+
+#endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "lttb.h"
+
+/* ---------- Funções Internas ---------- */
+
+// Amostra 'i' da série (0 = mais antiga), sem copiar o buffer
+static inline int32_t valor_serie(const serie_circular_t *s, uint32_t i) {
+    uint32_t posicao = s->inicio + i;
+    if (posicao >= s->capacidade) posicao -= s->capacidade;
+    return s->dados[posicao];
+}
+
+// Limite (exclusivo) do balde 'b': os n-2 pontos internos divididos em 'baldes' partes
+static inline uint16_t fim_balde(uint32_t b, uint32_t internos, uint32_t baldes) {
+    return (uint16_t)(1 + b * internos / baldes);
+}
+
+// Escolhe o ponto do balde 'b' com o maior triângulo entre o ponto 'a' e a média do balde seguinte
+static uint16_t escolher_no_balde(const lttb_iterador_t *it, uint32_t b, int32_t *y_escolhido) {
+    const serie_circular_t *s = &it->serie;
+    uint32_t baldes = it->pontos - 2, internos = s->quantidade - 2;
+    uint16_t inicio = fim_balde(b, internos, baldes);
+    uint16_t fim = fim_balde(b + 1, internos, baldes);
+
+    // Terceiro vértice: média do balde seguinte (no último balde, o último ponto)
+    uint16_t proximo_fim = (b + 1 < baldes) ? fim_balde(b + 2, internos, baldes) : s->quantidade;
+    int64_t soma = 0;
+    for (uint16_t i = fim; i < proximo_fim; i++) soma += valor_serie(s, i);
+    int64_t n = proximo_fim - fim;
+
+    // Área do triângulo vezes 2n, sem sinal: com xm = (fim + proximo_fim - 1) / 2 e
+    // ym = soma / n, fica 2(a - xm) * n(y - ya) - 2(a - i) * n(ym - ya), sem frações
+    int64_t dx_media = 2 * (int64_t)it->a - (fim + proximo_fim - 1);     // 2(a - xm)
+    int64_t dy_media = soma - n * it->ya;                                 // n(ym - ya)
+    int64_t maior = -1;
+    uint16_t escolhido = inicio;
+    for (uint16_t i = inicio; i < fim; i++) {
+        int32_t y = valor_serie(s, i);
+        int64_t area = dx_media * n * ((int64_t)y - it->ya) - 2 * ((int64_t)it->a - i) * dy_media;
+        if (area < 0) area = -area;
+        if (area > maior) {
+            maior = area;
+            escolhido = i;
+            *y_escolhido = y;
+        }
+    }
+    return escolhido;
+}
+
+/* ---------- Funções Públicas ---------- */
+
+void lttb_iniciar(lttb_iterador_t *it, const serie_circular_t *serie, uint16_t pontos) {
+    it->serie = *serie;
+    if (pontos < 3) pontos = 3;
+    it->pontos = (pontos < serie->quantidade) ? pontos : serie->quantidade;
+    it->emitidos = 0;
+    it->a = 0;
+    it->ya = 0;
+}
+
+bool lttb_proximo(lttb_iterador_t *it, uint16_t *indice, int32_t *valor) {
+    uint16_t n = it->serie.quantidade;
+    if (it->emitidos >= it->pontos) return false;
+
+    // Sem redução (série curta), o primeiro e o último ponto saem direto
+    if (it->pontos == n || it->emitidos == 0 || it->emitidos == it->pontos - 1) {
+        *indice = (it->pontos == n) ? it->emitidos : (it->emitidos == 0 ? 0 : n - 1);
+        *valor = valor_serie(&it->serie, *indice);
+    } else {
+        *indice = escolher_no_balde(it, it->emitidos - 1u, valor);
+    }
+    it->a = *indice;
+    it->ya = *valor;
+    it->emitidos++;
+    return true;
+}
+
+uint16_t lttb_reduzir(const serie_circular_t *serie, uint16_t pontos, lttb_ponto_cb emitir, void *contexto) {
+    lttb_iterador_t it;
+    lttb_iniciar(&it, serie, pontos);
+    uint16_t indice;
+    int32_t valor;
+    while (lttb_proximo(&it, &indice, &valor)) emitir(indice, valor, contexto);
+    return it.emitidos;
+}
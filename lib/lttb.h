@@ -0,0 +1,54 @@
+#ifndef LTTB_H
+#define LTTB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ---------- Redução de Séries (LTTB) ---------- */
+// Largest-Triangle-Three-Buckets: escolhe 'pontos' amostras de uma série
+// preservando sua forma visual (picos e vales), para desenhar históricos
+// longos em gráficos estreitos. O primeiro e o último ponto sempre entram;
+// o resto é dividido em baldes e, de cada balde, entra o ponto que forma o
+// maior triângulo com o ponto escolhido antes e a média do balde seguinte.
+//
+// A série é lida direto do buffer circular, numa única varredura pelos
+// baldes e sem cópia. Os pontos saem um a um de um iterador, que pode ser
+// retomado depois (para gerar uma resposta HTTP em partes), ou são
+// entregues a um callback assim que decididos (lttb_reduzir).
+//
+// Os valores são inteiros (os centésimos de lib/centesimos.h) e as áreas são
+// comparadas em inteiros de 64 bits, exatas e sem float.
+
+/* ---------- Série em Buffer Circular ---------- */
+typedef struct {
+    const int32_t *dados;    // Buffer circular
+    uint16_t capacidade;     // Tamanho do buffer
+    uint16_t inicio;         // Posição da amostra mais antiga da série
+    uint16_t quantidade;     // Amostras na série, da mais antiga para a mais nova
+} serie_circular_t;
+
+// Iterador sobre os pontos escolhidos; o estado cabe em poucos bytes
+typedef struct {
+    serie_circular_t serie;
+    uint16_t pontos;         // Pontos a entregar (já limitado ao tamanho da série)
+    uint16_t emitidos;       // Pontos já entregues
+    uint16_t a;              // Último ponto escolhido (vértice fixo do triângulo)
+    int32_t ya;
+} lttb_iterador_t;
+
+// Recebe cada ponto escolhido, em ordem; 'indice' é a posição na série (0 = mais antiga)
+typedef void (*lttb_ponto_cb)(uint16_t indice, int32_t valor, void *contexto);
+
+/* ---------- API ---------- */
+
+// Prepara a redução da série a no máximo 'pontos' amostras (pontos < 3 vale como 3)
+// Se a série já tem até 'pontos' amostras, todas são entregues
+void lttb_iniciar(lttb_iterador_t *it, const serie_circular_t *serie, uint16_t pontos);
+
+// Próximo ponto escolhido, da amostra mais antiga para a mais nova; false quando acabar
+bool lttb_proximo(lttb_iterador_t *it, uint16_t *indice, int32_t *valor);
+
+// Entrega os pontos de lttb_proximo() a 'emitir'; retorna quantos foram entregues
+uint16_t lttb_reduzir(const serie_circular_t *serie, uint16_t pontos, lttb_ponto_cb emitir, void *contexto);
+
+#endif // LTTB_H
@@ -0,0 +1,284 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include "registro_flash.h"
+
+/* ---------- Formato dos Registros ---------- */
+// Cada registro é um cabeçalho seguido do valor, alinhado a 8 bytes
+// (o Cortex-M0+ não lê palavras desalinhadas, nem pelo XIP)
+#define MARCA_REGISTRO 0x5A3C
+#define ALINHAMENTO    8
+#define SEM_REGISTRO   UINT32_MAX
+#define LIMITE_PAUSA_MS 100          // Espera máxima para o outro núcleo parar (flash_safe_execute)
+
+typedef struct {
+    uint16_t marca;          // MARCA_REGISTRO; 0xFFFF = espaço livre
+    uint8_t chave;
+    uint8_t reservado;       // 0xFF
+    uint16_t tamanho;        // Bytes do valor
+    uint16_t complemento;    // ~tamanho: rejeita um tamanho meio programado antes do CRC
+    uint32_t geracao;        // Cresce a cada registro gravado, em toda a área
+    uint32_t crc;            // CRC-32 dos campos acima e do valor
+} cabecalho_registro_t;
+
+#define TAM_CABECALHO sizeof(cabecalho_registro_t)
+
+estatisticas_registro_t estatisticas_registro = {0};
+
+// Estado do log, montado pela varredura de registro_iniciar()
+static uint32_t posicoes[REGISTRO_MAX_CHAVES];   // Registro atual de cada chave (deslocamento na área)
+static uint32_t proxima_geracao = 1;
+static uint16_t setor_atual = 0;
+static uint16_t ocupados = 0;                    // Próximo registro começa aqui, no setor atual
+
+// Registro em montagem: cabeçalho + valor contíguos, e a página a programar
+static uint8_t montagem[TAM_CABECALHO + REGISTRO_TAM_MAX];
+static uint8_t pagina[FLASH_PAGE_SIZE];
+
+/* ---------- Funções Internas ---------- */
+
+static inline const uint8_t *area(void) {
+    return (const uint8_t *)(XIP_BASE + REGISTRO_INICIO);
+}
+
+static inline uint32_t tamanho_total(uint16_t tamanho) {
+    return (TAM_CABECALHO + tamanho + ALINHAMENTO - 1) & ~(uint32_t)(ALINHAMENTO - 1);
+}
+
+// CRC-32 (polinômio 0xEDB88320) com tabela de 16 entradas: pouca flash e pouca RAM
+static uint32_t crc32(uint32_t crc, const uint8_t *dados, size_t tamanho) {
+    static const uint32_t TABELA[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    crc = ~crc;
+    while (tamanho--) {
+        crc ^= *dados++;
+        crc = (crc >> 4) ^ TABELA[crc & 0xF];
+        crc = (crc >> 4) ^ TABELA[crc & 0xF];
+    }
+    return ~crc;
+}
+
+static uint32_t crc_registro(const cabecalho_registro_t *c, const uint8_t *valor) {
+    uint32_t crc = crc32(0, (const uint8_t *)c, offsetof(cabecalho_registro_t, crc));
+    return crc32(crc, valor, c->tamanho);
+}
+
+static bool espaco_livre(const uint8_t *inicio, uint32_t tamanho) {
+    for (uint32_t i = 0; i < tamanho; i++) {
+        if (inicio[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+// Cabeçalho íntegro em 'posicao' (deslocamento dentro do setor 'setor'): o tamanho,
+// conferido pelo complemento, diz onde começa o próximo registro mesmo que o valor
+// não confira
+static bool cabecalho_integro(uint16_t setor, uint32_t posicao) {
+    const cabecalho_registro_t *c = (const cabecalho_registro_t *)(area() + setor * FLASH_SECTOR_SIZE + posicao);
+    if (c->marca != MARCA_REGISTRO || c->chave >= REGISTRO_MAX_CHAVES) return false;
+    if (c->tamanho > REGISTRO_TAM_MAX || c->complemento != (uint16_t)~c->tamanho) return false;
+    return posicao + tamanho_total(c->tamanho) <= FLASH_SECTOR_SIZE;
+}
+
+// Registro completo e íntegro em 'posicao'
+static bool registro_valido(uint16_t setor, uint32_t posicao) {
+    if (!cabecalho_integro(setor, posicao)) return false;
+    const cabecalho_registro_t *c = (const cabecalho_registro_t *)(area() + setor * FLASH_SECTOR_SIZE + posicao);
+    return c->crc == crc_registro(c, (const uint8_t *)(c + 1));
+}
+
+// Registra a duração de um bloqueio do XIP e o pior caso do tipo de operação
+static void medir_bloqueio(uint32_t duracao, uint32_t *pior) {
+    estatisticas_registro.ultimo_bloqueio_us = duracao;
+    if (duracao > *pior) *pior = duracao;
+}
+
+// Operação na flash executada por flash_safe_execute(): com as interrupções
+// desligadas e o outro núcleo parado fora da flash
+typedef struct {
+    uint32_t deslocamento;               // Na flash (não na área)
+    const uint8_t *dados;                // NULL = apagar o setor
+    uint32_t duracao_us;
+} operacao_flash_t;
+
+static void executar_operacao(void *parametro) {
+    operacao_flash_t *op = parametro;
+    uint32_t inicio = time_us_32();
+    if (op->dados) flash_range_program(op->deslocamento, op->dados, FLASH_PAGE_SIZE);
+    else flash_range_erase(op->deslocamento, FLASH_SECTOR_SIZE);
+    op->duracao_us = time_us_32() - inicio;
+}
+
+// Programa 'tamanho' bytes no deslocamento 'destino' da área, uma página por vez
+// Uma página que não pôde ser programada é pega pela conferência do registro
+// Bytes da página fora do trecho ficam 0xFF, que não alteram o que já está gravado
+static void programar(uint32_t destino, const uint8_t *dados, uint32_t tamanho) {
+    while (tamanho > 0) {
+        uint32_t inicio_pagina = destino & ~(uint32_t)(FLASH_PAGE_SIZE - 1);
+        uint32_t deslocamento = destino - inicio_pagina;
+        uint32_t trecho = FLASH_PAGE_SIZE - deslocamento;
+        if (trecho > tamanho) trecho = tamanho;
+
+        memset(pagina, 0xFF, sizeof(pagina));
+        memcpy(pagina + deslocamento, dados, trecho);
+
+        // Com o XIP parado, nada pode executar da flash, em nenhum dos dois núcleos
+        operacao_flash_t op = {.deslocamento = REGISTRO_INICIO + inicio_pagina, .dados = pagina};
+        if (flash_safe_execute(executar_operacao, &op, LIMITE_PAUSA_MS) == PICO_OK) {
+            medir_bloqueio(op.duracao_us, &estatisticas_registro.pior_programacao_us);
+        }
+
+        destino += trecho;
+        dados += trecho;
+        tamanho -= trecho;
+    }
+}
+
+// Um setor que não pôde ser apagado faz falhar a conferência do próximo registro gravado nele
+static void apagar_setor(uint16_t setor) {
+    operacao_flash_t op = {.deslocamento = REGISTRO_INICIO + setor * FLASH_SECTOR_SIZE, .dados = NULL};
+    if (flash_safe_execute(executar_operacao, &op, LIMITE_PAUSA_MS) != PICO_OK) return;
+    medir_bloqueio(op.duracao_us, &estatisticas_registro.pior_apagamento_us);
+    estatisticas_registro.apagamentos++;
+}
+
+// Grava o registro no fim do log e confere o que ficou na flash
+// 'valor' pode apontar para a própria área (cópia na troca de setor): é copiado antes
+static bool escrever_registro(uint8_t chave, const uint8_t *valor, uint16_t tamanho) {
+    cabecalho_registro_t c = {
+        .marca = MARCA_REGISTRO,
+        .chave = chave,
+        .reservado = 0xFF,
+        .tamanho = tamanho,
+        .complemento = (uint16_t)~tamanho,
+        .geracao = proxima_geracao,
+    };
+    memcpy(montagem + TAM_CABECALHO, valor, tamanho);
+    c.crc = crc_registro(&c, montagem + TAM_CABECALHO);
+    memcpy(montagem, &c, TAM_CABECALHO);
+
+    uint32_t posicao = setor_atual * FLASH_SECTOR_SIZE + ocupados;
+    programar(posicao, montagem, TAM_CABECALHO + tamanho);
+
+    // Ocupa o espaço mesmo se falhar: bytes meio programados não podem ser reaproveitados
+    // A varredura pula um registro que falhou com o cabeçalho íntegro; com o cabeçalho
+    // estragado ela pararia nele, então o resto do setor fica sem uso
+    bool integro = cabecalho_integro(setor_atual, ocupados);
+    ocupados += (uint16_t)tamanho_total(tamanho);
+    if (memcmp(area() + posicao, montagem, TAM_CABECALHO + tamanho) != 0) {
+        if (!integro) ocupados = FLASH_SECTOR_SIZE;
+        estatisticas_registro.ocupados = ocupados;
+        estatisticas_registro.falhas++;
+        return false;
+    }
+    estatisticas_registro.ocupados = ocupados;
+    posicoes[chave] = posicao;
+    proxima_geracao++;
+    estatisticas_registro.gravacoes++;
+    return true;
+}
+
+// Passa o log para o setor livre seguinte e apaga o mais antigo do anel,
+// que vira o novo setor livre; antes, copia os registros que ainda valem nele
+static void avancar_setor(void) {
+    setor_atual = (setor_atual + 1) % REGISTRO_NUM_SETORES;
+    ocupados = 0;
+    estatisticas_registro.setor = setor_atual;
+
+    uint16_t mais_antigo = (setor_atual + 1) % REGISTRO_NUM_SETORES;
+    for (uint8_t chave = 0; chave < REGISTRO_MAX_CHAVES; chave++) {
+        uint32_t posicao = posicoes[chave];
+        if (posicao == SEM_REGISTRO || posicao / FLASH_SECTOR_SIZE != mais_antigo) continue;
+        const cabecalho_registro_t *c = (const cabecalho_registro_t *)(area() + posicao);
+        // Uma cópia que falha não impede as seguintes: a varredura pula o registro estragado
+        // (ou, com o cabeçalho estragado, o setor já não recebe mais nada). Se a cópia não
+        // conferir ou não couber, a chave se perde com o apagamento, em vez de apontar para lixo
+        if (ocupados + tamanho_total(c->tamanho) > FLASH_SECTOR_SIZE ||
+            !escrever_registro(chave, (const uint8_t *)(c + 1), c->tamanho)) {
+            posicoes[chave] = SEM_REGISTRO;
+        }
+    }
+    apagar_setor(mais_antigo);
+}
+
+/* ---------- Funções Públicas ---------- */
+
+void registro_iniciar(void) {
+    uint32_t inicio = time_us_32();
+    uint32_t geracoes[REGISTRO_MAX_CHAVES] = {0};
+    uint16_t fins[REGISTRO_NUM_SETORES];
+    uint32_t maior_geracao = 0;
+
+    for (uint8_t chave = 0; chave < REGISTRO_MAX_CHAVES; chave++) posicoes[chave] = SEM_REGISTRO;
+    setor_atual = 0;
+
+    for (uint16_t setor = 0; setor < REGISTRO_NUM_SETORES; setor++) {
+        uint32_t posicao = 0;
+        while (posicao + TAM_CABECALHO <= FLASH_SECTOR_SIZE) {
+            const uint8_t *registro = area() + setor * FLASH_SECTOR_SIZE + posicao;
+            if (espaco_livre(registro, TAM_CABECALHO)) break;       // Fim do log neste setor
+            if (!registro_valido(setor, posicao)) {
+                estatisticas_registro.descartados++;
+                // Valor que não conferiu com o cabeçalho íntegro: só este registro é pulado
+                if (cabecalho_integro(setor, posicao)) {
+                    posicao += tamanho_total(((const cabecalho_registro_t *)registro)->tamanho);
+                    continue;
+                }
+                // Cabeçalho interrompido ou lixo: o resto do setor não é mais usado
+                posicao = FLASH_SECTOR_SIZE;
+                break;
+            }
+            const cabecalho_registro_t *c = (const cabecalho_registro_t *)registro;
+            if (c->geracao > geracoes[c->chave]) {
+                geracoes[c->chave] = c->geracao;
+                posicoes[c->chave] = setor * FLASH_SECTOR_SIZE + posicao;
+            }
+            if (c->geracao > maior_geracao) {
+                maior_geracao = c->geracao;
+                setor_atual = setor;
+            }
+            posicao += tamanho_total(c->tamanho);
+        }
+        fins[setor] = (uint16_t)posicao;
+    }
+
+    // O log continua depois do registro mais novo
+    proxima_geracao = maior_geracao + 1;
+    ocupados = fins[setor_atual];
+    estatisticas_registro.setor = setor_atual;
+    estatisticas_registro.ocupados = ocupados;
+    estatisticas_registro.varredura_us = time_us_32() - inicio;
+
+    // Garante o setor livre à frente (primeiro uso, ou queda de energia durante um apagamento)
+    uint16_t seguinte = (setor_atual + 1) % REGISTRO_NUM_SETORES;
+    if (!espaco_livre(area() + seguinte * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE)) apagar_setor(seguinte);
+}
+
+const uint8_t *registro_ler(uint8_t chave, uint16_t *tamanho) {
+    if (chave >= REGISTRO_MAX_CHAVES || posicoes[chave] == SEM_REGISTRO) return NULL;
+    const cabecalho_registro_t *c = (const cabecalho_registro_t *)(area() + posicoes[chave]);
+    *tamanho = c->tamanho;
+    return (const uint8_t *)(c + 1);
+}
+
+bool registro_gravar(uint8_t chave, const void *dados, uint16_t tamanho) {
+    if (chave >= REGISTRO_MAX_CHAVES || tamanho > REGISTRO_TAM_MAX) return false;
+
+    // Valor repetido não gasta a flash
+    uint16_t tam_atual;
+    const uint8_t *atual = registro_ler(chave, &tam_atual);
+    if (atual && tam_atual == tamanho && memcmp(atual, dados, tamanho) == 0) {
+        estatisticas_registro.ignoradas++;
+        return true;
+    }
+
+    // Uma segunda tentativa, já em outro setor, se a primeira não conferir
+    for (int tentativa = 0; tentativa < 2; tentativa++) {
+        if (ocupados + tamanho_total(tamanho) > FLASH_SECTOR_SIZE || tentativa > 0) avancar_setor();
+        if (escrever_registro(chave, dados, tamanho)) return true;
+    }
+    return false;
+}
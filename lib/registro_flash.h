@@ -0,0 +1,66 @@
+#ifndef REGISTRO_FLASH_H
+#define REGISTRO_FLASH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/flash.h"
+
+/* ---------- Área de Registros na Flash ---------- */
+// Log de registros chave/valor nos últimos setores da flash. Cada gravação
+// acrescenta um registro ao fim do log, com CRC e número de geração; o
+// registro válido de geração mais alta de cada chave é o valor atual.
+//
+// Os setores formam um anel e o setor seguinte ao atual fica sempre apagado.
+// Quando o atual enche, o log passa para ele e o mais antigo é apagado, depois
+// de os registros que ainda valem nele serem copiados adiante. Assim só há
+// apagamento quando um setor enche, e o desgaste se espalha pelo anel.
+//
+// Enquanto a flash programa ou apaga, o XIP para: flash_safe_execute()
+// desliga as interrupções e deixa o outro núcleo parado, executando da RAM
+// (o núcleo 1 precisa ter chamado flash_safe_execute_core_init()). Cada
+// bloqueio é limitado a uma página (≈0,4 ms típico, 3 ms no pior caso do
+// W25Q16JV) ou a um setor (≈45 ms típico, 400 ms no pior caso), e a duração
+// real de cada um é medida em estatisticas_registro.
+//
+// As funções de gravação não podem ser chamadas de interrupções (callbacks
+// do lwIP): chame do laço principal.
+
+#define REGISTRO_NUM_SETORES 4                  // Setores do anel (16 KB)
+#define REGISTRO_TAM_AREA    (REGISTRO_NUM_SETORES * FLASH_SECTOR_SIZE)
+#define REGISTRO_INICIO      (PICO_FLASH_SIZE_BYTES - REGISTRO_TAM_AREA)   // Deslocamento na flash
+#define REGISTRO_TAM_MAX     240                // Maior valor gravável, em bytes
+#define REGISTRO_MAX_CHAVES  8                  // Chaves 0 a 7
+
+// Chaves em uso
+#define REGISTRO_CHAVE_CONFIG 1                 // Configuração (lib/configuracao.h)
+
+/* ---------- Estatísticas ---------- */
+typedef struct {
+    uint32_t gravacoes;              // Registros gravados (inclui cópias na troca de setor)
+    uint32_t ignoradas;              // Gravações evitadas: valor igual ao já gravado
+    uint32_t apagamentos;            // Setores apagados
+    uint32_t falhas;                 // Registros que não conferiram após programados
+    uint32_t descartados;            // Registros corrompidos encontrados na varredura
+    uint32_t varredura_us;           // Duração da varredura de registro_iniciar()
+    uint32_t ultimo_bloqueio_us;     // XIP parado na última operação
+    uint32_t pior_programacao_us;    // Maior bloqueio ao programar uma página
+    uint32_t pior_apagamento_us;     // Maior bloqueio ao apagar um setor
+    uint16_t setor;                  // Setor em uso no anel
+    uint16_t ocupados;               // Bytes usados no setor atual
+} estatisticas_registro_t;
+
+extern estatisticas_registro_t estatisticas_registro;
+
+/* ---------- API da Área de Registros ---------- */
+
+// Varre a área uma vez: encontra o valor atual de cada chave e o fim do log
+void registro_iniciar(void);
+
+// Valor atual da chave, lido direto da flash (XIP); NULL se nunca foi gravado
+// O ponteiro vale até a próxima gravação
+const uint8_t *registro_ler(uint8_t chave, uint16_t *tamanho);
+
+// Acrescenta um novo valor para a chave; não grava se for igual ao atual
+bool registro_gravar(uint8_t chave, const void *dados, uint16_t tamanho);
+
+#endif // REGISTRO_FLASH_H
@@ -4,6 +4,8 @@
 #include <stdlib.h>
 #include "pico/stdlib.h"      
 #include "pico/cyw43_arch.h"   // Biblioteca para WiFi do Pico W
+#include "pico/multicore.h"   // Núcleo 1 dedicado à leitura dos sensores
+#include "pico/flash.h"       // Pausa do núcleo 1 durante gravações na flash
 #include "lwipopts.h"         // Configurações da pilha TCP/IP
 #include "lwipopts_examples_common.h"
 #include "hardware/i2c.h"     // Interface I2C para comunicação com sensores
@@ -19,6 +21,17 @@
 #include "font.h"             // Fonte para exibição de texto
 #include "matriz_led.h"       // Controle da matriz de LEDs
 #include "html.h"             // Páginas web armazenadas em memória
+#include "analisador_http.h"   // Analisador incremental de requisições HTTP
+#include "rotas_http.h"       // Tabela de rotas gerada a partir de rotas_http.def
+#include "websocket.h"        // Handshake e quadros WebSocket (RFC 6455)
+#include "telemetria.h"       // Formato binário compacto da amostra (/dados?fmt=bin)
+#include "escritor_json.h"    // JSON em ponto fixo, sem printf
+#include "lttb.h"             // Redução de séries para gráficos (Largest-Triangle-Three-Buckets)
+#include "configuracao.h"     // Limites e calibrações descritos por uma tabela única
+#include "registro_flash.h"   // Registros com CRC nos últimos setores da flash
+#include "barramento_i2c.h"   // Transações I2C por DMA, em fila por barramento
+#include "fila_amostras.h"    // Amostras do núcleo 1 para o núcleo 0, sem trava
+#include "centesimos.h"       // Leituras em centésimos inteiros, sem float no caminho
 
 /* =================== CONFIGURAÇÕES DE HARDWARE =================== */
 // Configuração do barramento I2C para os sensores (AHT20 e BMP280)
@@ -51,6 +64,25 @@
 #define NOME_WIFI "SUA_REDE_WIFI"      // Nome da rede WiFi para conexão
 #define SENHA_WIFI "SUA_SENHA"        // Senha da rede WiFi
 
+// Parâmetros do servidor HTTP
+#define TEMPO_OCIOSO_HTTP_S 15         // Fecha conexões keep-alive sem atividade após este tempo (s)
+#define MAX_REQUISICOES_CONEXAO 100    // Máximo de requisições atendidas por conexão
+#define TAM_CABECALHO_HTTP 256         // Maior cabeçalho de resposta montado na hora
+#define TAM_RESPOSTA_HTTP 2048         // Maior corpo dinâmico copiado para o lwIP (/config, /estatisticas)
+#define RESERVA_ENVIO_HTTP (TAM_CABECALHO_HTTP + TAM_RESPOSTA_HTTP) // Espaço em tcp_sndbuf para iniciar qualquer resposta
+#define MAX_CONEXOES_HTTP 8            // Conexões atendidas simultaneamente (slots pré-alocados)
+#define RETRY_AFTER_HTTP_S 2           // Sugestão de espera enviada ao cliente quando não há slot livre
+#define RECONEXAO_SSE_MS 3000          // Espera do EventSource antes de reconectar ao /stream
+#define TAM_JSON_DADOS 640             // Espaço para o JSON da amostra (/dados, /stream e /ws)
+#define TAM_LINHA_HISTORICO 64         // Espaço reservado por linha de /historico em cada pedaço gerado
+#define TAM_PEDACO_HTTP 1024           // Maior pedaço de um corpo gerado (Transfer-Encoding: chunked)
+#define MIN_PEDACO_HTTP 256            // Espaço mínimo em tcp_sndbuf para gerar o próximo pedaço
+#define TAM_CORPO_HTTP 512             // Maior corpo de requisição aceito (POST /config)
+
+// Converte o valor de uma macro em string literal (usado para montar respostas fixas)
+#define TEXTO(x) #x
+#define TEXTO_MACRO(x) TEXTO(x)
+
 /* =================== DEFINIÇÕES DAS TELAS DO SISTEMA =================== */
 // Enumera todas as telas disponíveis no sistema de navegação
 #define TELA_INICIAL 0               // Tela de boas-vindas/abertura
@@ -69,23 +101,15 @@
 #define TAMANHO_HISTORICO_WEB 100    // Quantos pontos ficam disponíveis via web
 #define TEMPO_DEBOUNCE_ZOOM_MS 120   // Tempo de debounce para o joystick de zoom
 
-/* =================== LIMITES DE MONITORAMENTO =================== */
-// Estes valores definem quando o sistema deve gerar alertas
-// Podem ser alterados via interface web
-float limite_temp_min = 20.0f;       // Temperatura mínima aceitável (°C)
-float limite_temp_max = 30.0f;       // Temperatura máxima aceitável (°C)
-float limite_umid_min = 40.0f;       // Umidade mínima aceitável (%)
-float limite_umid_max = 80.0f;       // Umidade máxima aceitável (%)
-float limite_press_min = 900.0f;     // Pressão mínima aceitável (hPa)
-float limite_press_max = 1000.0f;    // Pressão máxima aceitável (hPa)
-
-/* =================== CALIBRAÇÃO DOS SENSORES =================== */
-// Valores de ajuste para corrigir erros sistemáticos dos sensores
-// Podem ser configurados via interface web para melhorar a precisão
-float ajuste_temp_aht = 0.0f;        // Ajuste para temperatura do sensor AHT20
-float ajuste_temp_bmp = 0.0f;        // Ajuste para temperatura do sensor BMP280
-float ajuste_umidade = 0.0f;         // Ajuste para umidade do AHT20
-float ajuste_pressao = 0.0f;         // Ajuste para pressão do BMP280
+/* =================== LIMITES E CALIBRAÇÃO =================== */
+// Limites de alerta (temp_min ... press_max) e ajustes de calibração dos sensores
+// (offset_*) ficam em config_atual, descrita pela tabela de lib/configuracao.h
+// Podem ser alterados via interface web (POST /config) e sobrevivem a reinícios:
+// o loop principal grava a configuração na flash quando as alterações param
+#define ATRASO_GRAVACAO_CONFIG_MS 3000   // Espera sem alterações antes de gravar na flash
+volatile bool config_nao_salva = false;  // Houve alteração ainda não gravada
+volatile uint32_t instante_alteracao_config = 0; // Momento (ms) da última alteração
+volatile bool reavaliar_alertas = false; // Configuração mudou: o loop principal reavalia o estado
 
 /* =================== VARIÁVEIS DE CONTROLE DO SISTEMA =================== */
 bool wifi_conectado = false;         // Flag indicando se WiFi está conectado
@@ -94,41 +118,165 @@ char endereco_ip[24] = "Desconectado"; // String com o IP atual ou status de err
 // Controle da interface do usuário
 volatile uint8_t tela_ativa = TELA_INICIAL;       // Qual tela está sendo exibida atualmente
 volatile bool flag_atualizar_display = true;      // Sinaliza quando o display precisa ser atualizado
-volatile float fator_zoom_temp = 1.0f;            // Nível de zoom do gráfico de temperatura
-volatile float fator_zoom_umid = 1.0f;            // Nível de zoom do gráfico de umidade  
-volatile float fator_zoom_press = 1.0f;           // Nível de zoom do gráfico de pressão
+volatile uint8_t fator_zoom_temp = 10;            // Zoom do gráfico de temperatura, em décimos (10 = 1x)
+volatile uint8_t fator_zoom_umid = 10;            // Zoom do gráfico de umidade, em décimos
+volatile uint8_t fator_zoom_press = 10;           // Zoom do gráfico de pressão, em décimos
 static uint64_t ultimo_zoom_ms = 0;               // Timestamp da última ação de zoom
 volatile EstadoSistema estado_atual = ESTADO_NORMAL; // Estado atual do sistema para alertas
 
 /* =================== BUFFERS DE DADOS =================== */
 // Arrays circulares para armazenar histórico das leituras dos sensores
-float historico_temp[TAMANHO_BUFFER_GRAFICO];     // Histórico de temperatura para gráficos
-float historico_umid[TAMANHO_BUFFER_GRAFICO];     // Histórico de umidade para gráficos
-float historico_press[TAMANHO_BUFFER_GRAFICO];    // Histórico de pressão para gráficos
+// Todos em centésimos da unidade exibida (°C, %, hPa), como as leituras atuais
+int32_t historico_temp[TAMANHO_BUFFER_GRAFICO];   // Histórico de temperatura para gráficos
+int32_t historico_umid[TAMANHO_BUFFER_GRAFICO];   // Histórico de umidade para gráficos
+int32_t historico_press[TAMANHO_BUFFER_GRAFICO];  // Histórico de pressão para gráficos
 int indice_circular = 0;                          // Índice atual no buffer circular
 int contador_amostras = 0;                        // Quantas amostras já foram coletadas
 
 // Buffers maiores para disponibilizar dados via web
-float dados_web_temp[TAMANHO_HISTORICO_WEB];      // Histórico temperatura para web
-float dados_web_umid[TAMANHO_HISTORICO_WEB];      // Histórico umidade para web  
-float dados_web_press[TAMANHO_HISTORICO_WEB];     // Histórico pressão para web
+int32_t dados_web_temp[TAMANHO_HISTORICO_WEB];    // Histórico temperatura para web
+int32_t dados_web_umid[TAMANHO_HISTORICO_WEB];    // Histórico umidade para web
+int32_t dados_web_press[TAMANHO_HISTORICO_WEB];   // Histórico pressão para web
+// Faixa de cada intervalo (leituras rápidas do BMP280), nas mesmas posições do anel
+int32_t dados_web_temp_faixa_min[TAMANHO_HISTORICO_WEB];
+int32_t dados_web_temp_faixa_max[TAMANHO_HISTORICO_WEB];
+int32_t dados_web_press_faixa_min[TAMANHO_HISTORICO_WEB];
+int32_t dados_web_press_faixa_max[TAMANHO_HISTORICO_WEB];
 int indice_web = 0;                               // Índice atual no buffer web
 int contador_web = 0;                             // Quantas amostras web foram coletadas
+uint32_t sequencia_web = 0;                       // Número de sequência da amostra mais recente (0 = nenhuma)
 
 /* =================== LEITURAS ATUAIS DOS SENSORES =================== */
-float temp_aht = 0;      // Última temperatura lida do sensor AHT20 (°C)
-float temp_bmp = 0;      // Última temperatura lida do sensor BMP280 (°C)
-float temp_media = 0;    // Média das temperaturas dos dois sensores (°C)
-float umidade_atual = 0; // Última umidade lida do AHT20 (%)
-float pressao_atual = 0; // Última pressão lida do BMP280 (Pa)
+// Em centésimos (lib/centesimos.h): 2508 = 25,08 °C; a pressão em Pa já é centésimos de hPa
+int32_t temp_aht = 0;      // Última temperatura lida do sensor AHT20 (centésimos de °C)
+int32_t temp_bmp = 0;      // Última temperatura lida do sensor BMP280 (centésimos de °C)
+int32_t temp_media = 0;    // Média das temperaturas dos dois sensores (centésimos de °C)
+int32_t umidade_atual = 0; // Última umidade lida do AHT20 (centésimos de %)
+int32_t pressao_atual = 0; // Última pressão lida do BMP280 (Pa)
+agregado_t agregado_temp_bmp = {0};  // Faixa das leituras do BMP280 no último intervalo (centésimos de °C)
+agregado_t agregado_pressao = {0};   // Idem para a pressão (Pa)
+
+/* =================== AQUISIÇÃO NO NÚCLEO 1 =================== */
+// O núcleo 1 só lê e calibra os sensores, numa cadência que não depende da rede;
+// o núcleo 0 consome as amostras pela fila e cuida de histórico, alertas,
+// display e HTTP. O barramento dos sensores passa a ser usado só pelo núcleo 1
+// (as interrupções do I2C e do DMA continuam no núcleo 0, curtas)
+static fila_amostras_t fila_amostras;
+static struct bmp280_calib_param calibracao_bmp280;   // Lida na inicialização, antes do núcleo 1 começar
+
+// Escritas só pelo núcleo 1
+static volatile uint32_t amostras_coletadas = 0;
+static volatile uint32_t pior_atraso_coleta_us = 0;   // Início da coleta depois do agendado
 
 /* =================== ESTRUTURA PARA SERVIDOR HTTP =================== */
+struct estado_http;
+
+// Produz o próximo pedaço do corpo de uma resposta gerada, em até 'capacidade' bytes
+// Retorna quantos bytes escreveu; 0 encerra a resposta. Com pelo menos
+// MIN_PEDACO_HTTP - 8 bytes de capacidade, um gerador sempre avança
+typedef size_t (*gerador_resposta_t)(struct estado_http *hs, char *destino, size_t capacidade);
+
+// Estado de /historico enquanto a resposta é gerada (ver rota_historico)
+struct gerador_historico {
+    escritor_json_t json;        // Documento em andamento, continuado a cada pedaço
+    lttb_iterador_t lttb;        // Série em andamento (com ?pontos)
+    uint32_t primeira, ultima;   // Sequências disponíveis no anel quando a requisição chegou
+    uint32_t inicio, fim;        // Trecho pedido: [inicio, fim)
+    uint32_t proxima;            // Próxima linha (sem ?pontos)
+    uint16_t posicao_inicio;     // Posição de 'inicio' no anel
+    uint16_t pontos;             // Pontos por canal (0 = sem redução)
+    uint8_t canais;              // Máscara de CANAIS_HISTORICO
+    uint8_t canal;               // Canal em andamento (com ?pontos)
+    uint8_t etapa;
+    bool serie_aberta;           // Já escreveu a chave e o '[' da série do canal atual
+};
+
 // Esta estrutura armazena o estado de cada conexão HTTP
+// Guarda apenas um cursor sobre o corpo da resposta: as páginas geradas a partir
+// de paginas_web/ são enviadas direto da flash (XIP), sem cópia para a RAM
+// A conexão é persistente (keep-alive): várias requisições podem chegar em
+// sequência no mesmo socket e são atendidas em ordem
+// A requisição é analisada à medida que os segmentos chegam (analisador_http),
+// sem copiar o cabeçalho para um buffer intermediário
+// Uma conexão em /stream passa a ser um fluxo de eventos (Server-Sent Events):
+// cada nova amostra dos sensores é empurrada para ela por publicar_amostra_web()
+// Uma conexão em /ws é promovida a WebSocket: recebe as mesmas amostras e envia
+// comandos de configuração pelo mesmo socket; o decodificador de quadros ocupa
+// o lugar do analisador HTTP, que não é mais usado depois do upgrade
+// Corpos grandes gerados na hora (/historico) não são montados inteiros: um
+// gerador produz o próximo pedaço cada vez que há espaço no buffer de envio
 struct estado_http {
-    char resposta[12288];  // Buffer para montar a resposta HTTP (12KB)
-    size_t tamanho;        // Tamanho total da resposta em bytes
-    size_t enviado;        // Quantos bytes já foram enviados
+    struct tcp_pcb *pcb;     // PCB da conexão (NULL enquanto o slot está livre)
+    const uint8_t *corpo;    // Corpo da resposta (página na flash)
+    uint32_t tamanho;        // Tamanho total do corpo em bytes
+    uint32_t enfileirado;    // Quantos bytes do corpo já foram entregues ao lwIP
+    uint32_t pendente;       // Bytes (cabeçalho + corpo) enviados e ainda não confirmados
+    struct pbuf *recebido;   // Dados recebidos ainda não processados (requisições na fila)
+    union {
+        requisicao_http_t req;   // Estado do analisador para a requisição em andamento
+        decodificador_ws_t ws;   // Decodificador de quadros, após o upgrade para WebSocket
+    };
+    uint16_t requisicoes;    // Quantas requisições já foram atendidas nesta conexão
+    uint8_t ociosidade;      // Segundos sem atividade (fecha ao atingir TEMPO_OCIOSO_HTTP_S)
+    bool fechar_apos_envio;  // Fecha a conexão quando a resposta atual for confirmada
+    bool fluxo_eventos;      // Conexão assinante de /stream (não atende outras requisições)
+    bool websocket;          // Conexão promovida a WebSocket em /ws
+    bool pedacos;            // Corpo gerado vai com Transfer-Encoding: chunked (HTTP/1.1)
+    bool aguardando_corpo;   // Cabeçalho já analisado; esperando o corpo chegar inteiro
+    bool abortar;            // Resposta ficou truncada no lwIP: a conexão é abortada
+    gerador_resposta_t gerador;  // Produz o resto do corpo (NULL: corpo já entregue ou com cursor)
+    union {
+        struct gerador_historico historico;
+    } geracao;               // Estado do gerador em andamento
+};
+
+// Slots de conexão alocados estaticamente: o heap não é usado pelo servidor
+// A pilha 'slots_livres' guarda os índices disponíveis (aquisição e liberação em O(1))
+static struct estado_http conexoes_http[MAX_CONEXOES_HTTP];
+static uint8_t slots_livres[MAX_CONEXOES_HTTP];
+static uint8_t num_slots_livres = 0;
+
+// Contadores de uso do servidor, expostos em /estatisticas
+struct estatisticas_servidor {
+    uint32_t aceitas;        // Conexões que receberam um slot
+    uint32_t rejeitadas;     // Conexões recusadas com 503 por falta de slot
+    uint32_t erros;          // Conexões derrubadas por reset/erro (tcp_err)
+    uint32_t expiradas;      // Conexões fechadas por ociosidade
+    uint32_t sem_rota;       // Requisições para caminhos fora da tabela de rotas
+    uint32_t revalidadas;    // Páginas respondidas com 304 (cópia do navegador ainda válida)
+    uint32_t eventos_sse;    // Eventos SSE entregues aos assinantes de /stream
+    uint32_t descartes_sse;  // Eventos não enviados por falta de espaço no buffer TCP
+    uint32_t eventos_ws;     // Amostras entregues aos clientes WebSocket
+    uint32_t descartes_ws;   // Amostras WebSocket não enviadas por falta de espaço
+    uint32_t comandos_ws;    // Comandos de configuração recebidos por WebSocket
+    uint32_t montagens;      // Vezes que a amostra foi formatada para a web (uma por mudança)
+    uint8_t pico_ocupados;   // Maior número de slots ocupados ao mesmo tempo
+    uint8_t assinantes_sse;  // Conexões abertas em /stream
+    uint8_t assinantes_ws;   // Conexões abertas em /ws
 };
+static struct estatisticas_servidor estatisticas_http = {0};
+
+// Amostra já formatada em todas as representações servidas pela web
+// Os valores só mudam a cada leitura dos sensores ou quando limites e calibrações
+// são alterados: a formatação é feita uma vez após a mudança e todas as
+// requisições, eventos SSE e quadros WebSocket copiam os bytes prontos
+struct cache_dados_web {
+    uint8_t quadro_ws[WS_TAM_MAX_CABECALHO + TAM_JSON_DADOS]; // JSON após o espaço do cabeçalho WebSocket
+    char evento_sse[TAM_JSON_DADOS + 8];   // "data: " + JSON + "\n\n"
+    char cabecalho_json[112];              // Cabeçalho de /dados em JSON (sem a parte de conexão)
+    char cabecalho_binario[112];           // Cabeçalho de /dados no formato binário
+    uint8_t telemetria[TELEMETRIA_TAMANHO];
+    uint16_t tam_json;
+    uint16_t tam_evento;
+    uint8_t tam_cabecalho_json;
+    uint8_t tam_cabecalho_binario;
+    bool valido;                           // false: precisa formatar de novo antes de usar
+};
+static struct cache_dados_web cache_dados = {0};
+
+// Corpo da requisição em atendimento: válido só durante a chamada do tratador da rota
+static char corpo_http[TAM_CORPO_HTTP + 1];
+static uint16_t tam_corpo_http = 0;
 
 /* =================== PROTÓTIPOS DAS FUNÇÕES =================== */
 // Funções de inicialização do hardware
@@ -137,11 +285,15 @@ void configurar_botoes_navegacao(void);
 void configurar_joystick_zoom(void);
 void configurar_leds_status(void);
 void inicializar_conexao_wifi(ssd1306_t *);
+void restaurar_configuracao(void);
+void salvar_configuracao_pendente(void);
 void iniciar_servidor_web(void);
+void publicar_amostra_web(void);
+void invalidar_cache_dados(void);
 
 // Funções para desenho de cada tela
 void exibir_tela_inicial(ssd1306_t *);
-void exibir_dados_sensores(ssd1306_t *, float, float, float, float, float);
+void exibir_dados_sensores(ssd1306_t *, int32_t, int32_t, int32_t, int32_t, int32_t);
 void exibir_status_conexao(ssd1306_t *);
 void exibir_grafico_temperatura(ssd1306_t *);
 void exibir_grafico_umidade(ssd1306_t *);
@@ -149,8 +301,12 @@ void exibir_grafico_pressao(ssd1306_t *);
 void exibir_status_led_rgb(ssd1306_t *);
 
 // Funções de controle principal
-void atualizar_display_principal(ssd1306_t *, float, float, float, float, float);
-void coletar_dados_todos_sensores(struct bmp280_calib_param *, float *, float *, float *, float *, float *);
+void atualizar_display_principal(ssd1306_t *, int32_t, int32_t, int32_t, int32_t, int32_t);
+bool coletar_dados_todos_sensores(const configuracao_t *, struct bmp280_calib_param *, int32_t *, int32_t *, int32_t *, int32_t *, int32_t *, bool *);
+void configurar_bmp280(const configuracao_t *);
+bool ler_bmp280(const configuracao_t *, struct bmp280_calib_param *, int32_t *, int32_t *);
+void nucleo1_aquisicao(void);
+void processar_amostra(const amostra_sensores_t *);
 
 // Funções de callback (chamadas por interrupções)
 void processar_botoes_pressionados(uint, uint32_t);
@@ -165,142 +321,1317 @@ const char* obter_animacao_estado_texto(EstadoSistema);
 // Funções para alertas sonoros
 void configurar_buzzer_alertas(void);
 void processar_alertas_sonoros(EstadoSistema);
-void definir_frequencia_buzzer(uint, float);
+void definir_frequencia_buzzer(uint, uint32_t);
 
 /* =================== FUNÇÕES DO SERVIDOR WEB =================== */
+static err_t processar_requisicoes_pendentes(struct tcp_pcb *tpcb, struct estado_http *hs);
+static void difundir_amostra(void);
+
+// Resposta enviada quando todos os slots estão ocupados (fica na flash, enviada sem cópia)
+static const char RESPOSTA_HTTP_503[] =
+    "HTTP/1.1 503 Service Unavailable\r\n"
+    "Retry-After: " TEXTO_MACRO(RETRY_AFTER_HTTP_S) "\r\n"
+    "Content-Length: 0\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+
+// Preenche a pilha de slots livres (chamada uma vez, ao iniciar o servidor)
+static void inicializar_slots_http(void) {
+    for (int i = 0; i < MAX_CONEXOES_HTTP; i++) {
+        slots_livres[i] = MAX_CONEXOES_HTTP - 1 - i;
+    }
+    num_slots_livres = MAX_CONEXOES_HTTP;
+}
+
+// Retira um slot da pilha de livres; retorna NULL se todos estiverem ocupados
+static struct estado_http *adquirir_slot_http(void) {
+    if (num_slots_livres == 0) return NULL;
+    struct estado_http *hs = &conexoes_http[slots_livres[--num_slots_livres]];
+    memset(hs, 0, sizeof(*hs));
+    analisador_http_iniciar(&hs->req);
+
+    uint8_t ocupados = MAX_CONEXOES_HTTP - num_slots_livres;
+    if (ocupados > estatisticas_http.pico_ocupados) estatisticas_http.pico_ocupados = ocupados;
+    return hs;
+}
+
+// Devolve o slot à pilha de livres, liberando a fila de dados recebidos
+static void liberar_slot_http(struct estado_http *hs) {
+    if (hs->recebido) {
+        pbuf_free(hs->recebido);
+        hs->recebido = NULL;
+    }
+    if (hs->fluxo_eventos) estatisticas_http.assinantes_sse--;
+    if (hs->websocket) estatisticas_http.assinantes_ws--;
+    hs->fluxo_eventos = false;
+    hs->websocket = false;
+    hs->pcb = NULL;
+    slots_livres[num_slots_livres++] = (uint8_t)(hs - conexoes_http);
+}
+
+// Fecha a conexão e libera o estado associado a ela
+// Retorna ERR_ABRT se foi preciso abortar, valor que deve ser repassado ao lwIP
+static err_t encerrar_conexao_http(struct tcp_pcb *tpcb, struct estado_http *hs) {
+    tcp_arg(tpcb, NULL);
+    tcp_recv(tpcb, NULL);
+    tcp_sent(tpcb, NULL);
+    tcp_poll(tpcb, NULL, 0);
+    tcp_err(tpcb, NULL);
+    liberar_slot_http(hs);
+    if (tcp_close(tpcb) != ERR_OK) {
+        tcp_abort(tpcb);   // Sem memória para o FIN: aborta a conexão
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+// Aborta a conexão (RST) e libera o estado associado a ela; retorna ERR_ABRT ao lwIP
+static err_t abortar_conexao_http(struct tcp_pcb *tpcb, struct estado_http *hs) {
+    tcp_arg(tpcb, NULL);
+    tcp_recv(tpcb, NULL);
+    tcp_sent(tpcb, NULL);
+    tcp_poll(tpcb, NULL, 0);
+    tcp_err(tpcb, NULL);
+    liberar_slot_http(hs);
+    tcp_abort(tpcb);
+    return ERR_ABRT;
+}
+
+// Resposta atual inteira entregue ao lwIP (pode haver bytes ainda não confirmados)
+static inline bool resposta_entregue(const struct estado_http *hs) {
+    return hs->enfileirado >= hs->tamanho && !hs->gerador;
+}
+
+// Pede ao gerador novos pedaços do corpo enquanto houver espaço em tcp_sndbuf()
+// Cada pedaço é produzido num buffer compartilhado e copiado pelo lwIP na hora:
+// a RAM usada não depende do tamanho do corpo
+static void gerar_proximos_pedacos(struct tcp_pcb *tpcb, struct estado_http *hs) {
+    // Moldura do chunked: até 6 dígitos hexadecimais + "\r\n" antes dos dados, "\r\n" depois
+    static char pedaco[8 + TAM_PEDACO_HTTP + 2];
+    char *dados = pedaco + 8;
+
+    while (hs->gerador) {
+        uint32_t livre = tcp_sndbuf(tpcb);
+        if (livre < MIN_PEDACO_HTTP || tcp_sndqueuelen(tpcb) >= TCP_SND_QUEUELEN - 2) break;
+        size_t capacidade = livre - 12;
+        if (capacidade > TAM_PEDACO_HTTP) capacidade = TAM_PEDACO_HTTP;
+
+        size_t tamanho = hs->gerador(hs, dados, capacidade);
+        const char *inicio = dados;
+        size_t total = tamanho;
+        if (tamanho == 0) {
+            hs->gerador = NULL;
+            if (!hs->pedacos) break;             // HTTP/1.0: o corpo termina com o fechamento
+            inicio = "0\r\n\r\n";                 // Pedaço final
+            total = 5;
+        } else if (hs->pedacos) {
+            // Tamanho em hexadecimal logo antes dos dados e "\r\n" depois
+            char *p = dados;
+            *--p = '\n';
+            *--p = '\r';
+            for (size_t t = tamanho; ; t >>= 4) {
+                *--p = "0123456789abcdef"[t & 0xF];
+                if (t < 16) break;
+            }
+            dados[tamanho] = '\r';
+            dados[tamanho + 1] = '\n';
+            inicio = p;
+            total = (size_t)(dados + tamanho + 2 - p);
+        }
+
+        if (tcp_write(tpcb, inicio, (u16_t)total, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+            // O pedaço já foi produzido e não pode ser refeito: encerra a conexão com o corpo
+            // incompleto, o que o cliente percebe pela falta do pedaço final
+            hs->gerador = NULL;
+            hs->fechar_apos_envio = true;
+            break;
+        }
+        hs->pendente += total;
+    }
+}
+
+// Entrega ao lwIP o próximo trecho do corpo, limitado ao espaço livre em tcp_sndbuf()
+// Os dados não são copiados: o lwIP referencia diretamente a página na flash
+// Respostas geradas recebem aqui os próximos pedaços
+static void enviar_proximo_trecho(struct tcp_pcb *tpcb, struct estado_http *hs) {
+    while (hs->enfileirado < hs->tamanho) {
+        uint32_t restante = hs->tamanho - hs->enfileirado;
+        uint32_t trecho = tcp_sndbuf(tpcb);
+        if (trecho == 0) break;                  // Buffer cheio: continua no callback_envio_http
+        if (trecho > restante) trecho = restante;
+
+        u8_t flags = (trecho < restante) ? TCP_WRITE_FLAG_MORE : 0;
+        if (tcp_write(tpcb, hs->corpo + hs->enfileirado, (u16_t)trecho, flags) != ERR_OK) {
+            break;                               // Fila cheia: tenta novamente mais tarde
+        }
+        hs->enfileirado += trecho;
+        hs->pendente += trecho;
+    }
+    if (hs->gerador) gerar_proximos_pedacos(tpcb, hs);
+    tcp_output(tpcb);                            // Força envio imediato
+}
+
+// Informa ao cliente se a conexão continua aberta para as próximas requisições
+// Escreve também a linha vazia que encerra o cabeçalho; retorna o número de bytes
+static int escrever_cabecalho_conexao(const struct estado_http *hs, char *destino, size_t tamanho) {
+    if (hs->fechar_apos_envio) {
+        return snprintf(destino, tamanho, "Connection: close\r\n\r\n");
+    }
+    return snprintf(destino, tamanho,
+        "Connection: keep-alive\r\nKeep-Alive: timeout=%d, max=%d\r\n\r\n",
+        TEMPO_OCIOSO_HTTP_S, MAX_REQUISICOES_CONEXAO - hs->requisicoes);
+}
+
+_Static_assert(RESERVA_ENVIO_HTTP <= TCP_SND_BUF, "a maior resposta copiada precisa caber no buffer de envio");
+
+// Espaço no buffer de envio e na fila de segmentos do lwIP para 'tamanho' bytes copiados
+// em 'escritas' chamadas de tcp_write (cada uma ocupa ao menos um pbuf, mais um por MSS)
+static inline bool cabe_no_envio(struct tcp_pcb *tpcb, uint32_t tamanho, uint32_t escritas) {
+    return tcp_sndbuf(tpcb) >= tamanho &&
+           tcp_sndqueuelen(tpcb) + escritas + tamanho / TCP_MSS <= TCP_SND_QUEUELEN;
+}
+
+// Confere, antes de escrever qualquer byte, se a parte copiada da resposta cabe no envio
+// processar_requisicoes_pendentes só atende uma requisição com RESERVA_ENVIO_HTTP livre;
+// se mesmo assim faltar espaço, nada é escrito e a conexão é fechada sem a resposta
+static bool reservar_envio_http(struct tcp_pcb *tpcb, struct estado_http *hs, uint32_t tamanho, uint32_t escritas) {
+    hs->corpo = NULL;
+    hs->tamanho = 0;
+    hs->enfileirado = 0;
+    if (cabe_no_envio(tpcb, tamanho, escritas)) return true;
+    hs->fechar_apos_envio = true;
+    return false;
+}
+
+// Entrega um trecho da resposta ao lwIP; só o que foi aceito entra em 'pendente'
+// Se a falha vem depois de outro trecho da mesma resposta, o cliente ficaria com
+// ela truncada e sem como delimitá-la: a conexão é abortada
+static bool escrever_trecho_http(struct tcp_pcb *tpcb, struct estado_http *hs, const void *dados,
+                                 uint16_t tamanho, u8_t flags, bool primeiro) {
+    if (tcp_write(tpcb, dados, tamanho, flags) != ERR_OK) {
+        hs->fechar_apos_envio = true;
+        if (!primeiro) hs->abortar = true;
+        return false;
+    }
+    hs->pendente += tamanho;
+    return true;
+}
+
+// Texto da linha de status; códigos não previstos viram 400
+static const char *texto_status_http(uint16_t *status) {
+    switch (*status) {
+        case 200: return "OK";
+        case 405: return "Method Not Allowed";
+        case 406: return "Not Acceptable";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 414: return "URI Too Long";
+        case 426: return "Upgrade Required";
+        case 431: return "Request Header Fields Too Large";
+        case 501: return "Not Implemented";
+        case 505: return "HTTP Version Not Supported";
+        default:  *status = 400; return "Bad Request";
+    }
+}
+
+// Envia cabeçalho e corpo de uma resposta HTTP com o status dado
+// Corpos dinâmicos (JSON, texto) são pequenos e são copiados para o lwIP;
+// páginas da flash são enviadas em partes a partir do cursor em estado_http
+static void enviar_resposta_status_http(struct tcp_pcb *tpcb, struct estado_http *hs, uint16_t status,
+                                        const char *tipo, const char *cabecalhos_extras, const void *corpo,
+                                        uint32_t tamanho, bool corpo_na_flash) {
+    const char *texto = texto_status_http(&status);
+    char cabecalho[TAM_CABECALHO_HTTP];
+    int tam_cabecalho = snprintf(cabecalho, sizeof(cabecalho),
+        "HTTP/1.1 %u %s\r\n"                   // Linha de status
+        "Content-Type: %s\r\n"                 // Tipo de conteúdo
+        "Content-Length: %lu\r\n"              // Tamanho do conteúdo
+        "%s",                                  // Cabeçalhos específicos da resposta
+        status, texto, tipo, (unsigned long)tamanho, cabecalhos_extras);
+
+    tam_cabecalho += escrever_cabecalho_conexao(hs, cabecalho + tam_cabecalho, sizeof(cabecalho) - tam_cabecalho);
+
+    // Corpo dinâmico vive na pilha de quem chamou: precisa ser copiado agora, junto
+    // com o cabeçalho; o da flash segue depois, pelo cursor
+    uint32_t copiado = corpo_na_flash ? 0 : tamanho;
+    if (!reservar_envio_http(tpcb, hs, tam_cabecalho + copiado, 2)) return;
+    if (!escrever_trecho_http(tpcb, hs, cabecalho, tam_cabecalho, TCP_WRITE_FLAG_COPY, true)) return;
+    if (copiado && !escrever_trecho_http(tpcb, hs, corpo, copiado, TCP_WRITE_FLAG_COPY, false)) return;
+
+    hs->corpo = corpo;
+    hs->tamanho = tamanho;
+    hs->enfileirado = copiado;
+    enviar_proximo_trecho(tpcb, hs);
+}
+
+// Resposta de sucesso (200), o caso comum
+static void enviar_resposta_http(struct tcp_pcb *tpcb, struct estado_http *hs, const char *tipo,
+                                 const char *cabecalhos_extras, const void *corpo, uint32_t tamanho,
+                                 bool corpo_na_flash) {
+    enviar_resposta_status_http(tpcb, hs, 200, tipo, cabecalhos_extras, corpo, tamanho, corpo_na_flash);
+}
+
+// Inicia uma resposta cujo corpo é produzido aos pedaços por 'gerador' à medida que
+// o cliente confirma o recebimento; quem chama preenche antes o estado em hs->geracao
+// Em HTTP/1.1 o corpo vai com Transfer-Encoding: chunked; HTTP/1.0 não conhece
+// chunked, então o corpo vai cru e termina com o fechamento da conexão
+static void enviar_resposta_gerada(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req,
+                                   const char *tipo, const char *cabecalhos_extras, gerador_resposta_t gerador) {
+    hs->pedacos = req->versao_menor >= 1;
+    if (!hs->pedacos) hs->fechar_apos_envio = true;
+
+    char cabecalho[TAM_CABECALHO_HTTP];
+    int tam_cabecalho = snprintf(cabecalho, sizeof(cabecalho),
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: %s\r\n"
+        "%s"
+        "%s",
+        tipo, hs->pedacos ? "Transfer-Encoding: chunked\r\n" : "", cabecalhos_extras);
+    tam_cabecalho += escrever_cabecalho_conexao(hs, cabecalho + tam_cabecalho, sizeof(cabecalho) - tam_cabecalho);
+
+    if (!reservar_envio_http(tpcb, hs, tam_cabecalho, 1)) return;
+    if (!escrever_trecho_http(tpcb, hs, cabecalho, tam_cabecalho, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE, true)) {
+        return;
+    }
+
+    hs->gerador = gerador;
+    enviar_proximo_trecho(tpcb, hs);
+}
+
+// Envia uma resposta com cabeçalho (sem a parte de conexão) e corpo já formatados
+// Usada pelas respostas em cache: por requisição resta só o cabeçalho de conexão
+// A resposta inteira cabe na reserva exigida para atender a requisição
+_Static_assert(sizeof(cache_dados.cabecalho_json) + 80 + TAM_JSON_DADOS <= RESERVA_ENVIO_HTTP,
+               "/dados em cache precisa caber na reserva de envio");
+static void enviar_resposta_pronta(struct tcp_pcb *tpcb, struct estado_http *hs, const char *cabecalho,
+                                   uint16_t tam_cabecalho, const void *corpo, uint16_t tamanho) {
+    char conexao[80];
+    int tam_conexao = escrever_cabecalho_conexao(hs, conexao, sizeof(conexao));
+
+    // Tudo é copiado: o cache pode ser refeito antes de o cliente confirmar o recebimento
+    if (!reservar_envio_http(tpcb, hs, tam_cabecalho + tam_conexao + tamanho, 3)) return;
+    if (!escrever_trecho_http(tpcb, hs, cabecalho, tam_cabecalho, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE, true) ||
+        !escrever_trecho_http(tpcb, hs, conexao, tam_conexao, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE, false) ||
+        !escrever_trecho_http(tpcb, hs, corpo, tamanho, TCP_WRITE_FLAG_COPY, false)) {
+        return;
+    }
+
+    hs->corpo = corpo;
+    hs->tamanho = tamanho;
+    hs->enfileirado = tamanho;
+    tcp_output(tpcb);
+}
+
+// Responde apenas com uma linha de status (erros) e encerra a conexão após o envio
+static void enviar_status_http(struct tcp_pcb *tpcb, struct estado_http *hs, uint16_t status) {
+    const char *texto = texto_status_http(&status);
+
+    // 426 informa a única versão de WebSocket aceita
+    const char *extra = (status == 426) ? "Sec-WebSocket-Version: 13\r\n" : "";
+    char resposta[160];
+    int tam = snprintf(resposta, sizeof(resposta),
+        "HTTP/1.1 %u %s\r\n"
+        "%s"
+        "Content-Length: 0\r\n"
+        "Connection: close\r\n\r\n",
+        status, texto, extra);
+
+    hs->fechar_apos_envio = true;
+    if (!reservar_envio_http(tpcb, hs, tam, 1)) return;
+    if (escrever_trecho_http(tpcb, hs, resposta, tam, TCP_WRITE_FLAG_COPY, true)) tcp_output(tpcb);
+}
+
+// Envia uma das páginas web geradas no build, já comprimidas com gzip
+// O hash do conteúdo, calculado no build, é usado como ETag forte: com
+// Cache-Control: no-cache o navegador revalida a cada navegação e, se a
+// página não mudou, recebe só o cabeçalho 304, sem o corpo
+// Só a versão gzip está na flash: 406 apenas para quem recusa gzip no Accept-Encoding
+// (RFC 9110, 12.5.3); sem o cabeçalho, qualquer codificação é aceitável
+static void enviar_pagina_http(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req,
+                               const pagina_web_t *pagina) {
+    if (!req->aceita_gzip) {
+        enviar_status_http(tpcb, hs, 406);
+        return;
+    }
+
+    char etag[24];
+    snprintf(etag, sizeof(etag), "\"%s\"", pagina->hash);
+
+    // If-None-Match pode trazer uma lista de ETags ou "*"
+    if (req->if_none_match[0] && (strstr(req->if_none_match, etag) || strcmp(req->if_none_match, "*") == 0)) {
+        char cabecalho[192];
+        int tam_cabecalho = snprintf(cabecalho, sizeof(cabecalho),
+            "HTTP/1.1 304 Not Modified\r\n"
+            "ETag: %s\r\n"
+            "Cache-Control: no-cache\r\n"
+            "Vary: Accept-Encoding\r\n",
+            etag);
+        tam_cabecalho += escrever_cabecalho_conexao(hs, cabecalho + tam_cabecalho, sizeof(cabecalho) - tam_cabecalho);
+
+        if (reservar_envio_http(tpcb, hs, tam_cabecalho, 1) &&
+            escrever_trecho_http(tpcb, hs, cabecalho, tam_cabecalho, TCP_WRITE_FLAG_COPY, true)) {
+            tcp_output(tpcb);
+            estatisticas_http.revalidadas++;
+        }
+        return;
+    }
+
+    char extras[128];
+    snprintf(extras, sizeof(extras),
+        "Content-Encoding: gzip\r\n"
+        "Vary: Accept-Encoding\r\n"
+        "Cache-Control: no-cache\r\n"
+        "ETag: %s\r\n",
+        etag);
+    enviar_resposta_http(tpcb, hs, "text/html; charset=utf-8", extras, pagina->dados, pagina->tamanho, true);
+}
+
+// Cada função abaixo atende uma rota declarada em rotas_http.def
+// A escolha da rota é feita por processar_requisicao, via TABELA_ROTAS_HTTP
+
+// Páginas web geradas no build (HTML + JavaScript comprimidos)
+void rota_pagina_inicial(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req) {
+    enviar_pagina_http(tpcb, hs, req, &HTML_BODY);          // Dashboard com dados dos sensores
+}
+
+void rota_pagina_graficos(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req) {
+    enviar_pagina_http(tpcb, hs, req, &HTML_GRAFICOS);      // Gráficos interativos
+}
+
+void rota_pagina_estados(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req) {
+    enviar_pagina_http(tpcb, hs, req, &HTML_ESTADOS);       // Estados do sistema e alertas
+}
+
+void rota_pagina_limites(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req) {
+    enviar_pagina_http(tpcb, hs, req, &HTML_LIMITES);       // Configuração dos limites de alerta
+}
+
+void rota_pagina_calibracao(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req) {
+    enviar_pagina_http(tpcb, hs, req, &HTML_CALIBRACAO);    // Ajuste de calibração dos sensores
+}
+
+// Monta o JSON com as leituras atuais, limites e calibrações
+// Mesmo conteúdo para /dados e para os eventos de /stream e /ws (via cache_dados)
+// As leituras já são centésimos e saem com 2 casas, como o "%.2f" usado antes, sem float
+static int montar_json_dados(char *destino, size_t tamanho) {
+    escritor_json_t j;
+    json_iniciar(&j, destino, tamanho);
+    json_abrir_objeto(&j);
+    json_membro_fixo(&j, "temp_aht", temp_aht, 2);
+    json_membro_fixo(&j, "temp_bmp", temp_bmp, 2);
+    json_membro_fixo(&j, "temp_media", temp_media, 2);
+    json_membro_fixo(&j, "umidade", umidade_atual, 2);
+    json_membro_fixo(&j, "pressao", pressao_atual, 2);             // Pa = centésimos de hPa
+    // Resumo das leituras do BMP280 no intervalo da amostra
+    json_chave(&j, "intervalo");
+    json_abrir_objeto(&j);
+    json_membro_natural(&j, "leituras", agregado_pressao.contagem);
+    json_membro_fixo(&j, "temp_bmp_min", agregado_temp_bmp.minimo, 2);
+    json_membro_fixo(&j, "temp_bmp_max", agregado_temp_bmp.maximo, 2);
+    json_membro_fixo(&j, "pressao_min", agregado_pressao.minimo, 2);
+    json_membro_fixo(&j, "pressao_max", agregado_pressao.maximo, 2);
+    json_fechar_objeto(&j);
+    config_escrever_valores(&j, &config_atual);      // Limites e calibrações, na ordem da tabela
+    json_membro_natural(&j, "seq", sequencia_web);   // Amostra mais recente em /historico
+    json_membro_natural(&j, "versao_config", versao_config);
+    json_fechar_objeto(&j);
+    return (int)json_terminar(&j);
+}
+
+// Monta a amostra atual no formato binário de telemetria.h (84 bytes, sem formatação)
+// O formato tem campos fixos: um campo novo na configuração não entra aqui sozinho
+// Os campos do formato são float: é uma das bordas onde os centésimos viram float
+static int montar_telemetria_dados(uint8_t *destino) {
+    const configuracao_t *c = &config_atual;
+#define EM_REAL(centesimos) centesimos_para_real(centesimos)
+    const telemetria_t amostra = {
+        EM_REAL(temp_aht), EM_REAL(temp_bmp), EM_REAL(temp_media), EM_REAL(umidade_atual), EM_REAL(pressao_atual),
+        EM_REAL(c->temp_min), EM_REAL(c->temp_max), EM_REAL(c->umid_min), EM_REAL(c->umid_max),
+        EM_REAL(c->press_min), EM_REAL(c->press_max),
+        EM_REAL(c->offset_temp_aht), EM_REAL(c->offset_temp_bmp), EM_REAL(c->offset_umid), EM_REAL(c->offset_press),
+        (float)agregado_pressao.contagem,
+        EM_REAL(agregado_temp_bmp.minimo), EM_REAL(agregado_temp_bmp.maximo),
+        EM_REAL(agregado_pressao.minimo), EM_REAL(agregado_pressao.maximo),
+    };
+#undef EM_REAL
+    return telemetria_codificar(&amostra, destino);
+}
+
+// Formata a amostra atual em todas as representações, se algo mudou desde a última vez
+static const struct cache_dados_web *obter_cache_dados(void) {
+    struct cache_dados_web *c = &cache_dados;
+    if (c->valido) return c;
+
+    char *json = (char *)c->quadro_ws + WS_TAM_MAX_CABECALHO;
+    c->tam_json = (uint16_t)montar_json_dados(json, TAM_JSON_DADOS);
+
+    memcpy(c->evento_sse, "data: ", 6);
+    memcpy(c->evento_sse + 6, json, c->tam_json);
+    memcpy(c->evento_sse + 6 + c->tam_json, "\n\n", 2);
+    c->tam_evento = c->tam_json + 8;
+
+    int tam_telemetria = montar_telemetria_dados(c->telemetria);
+
+    static const char FORMATO_CABECALHO[] =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: %s\r\n"
+        "Content-Length: %u\r\n"
+        "Vary: Accept\r\n";
+    c->tam_cabecalho_json = (uint8_t)snprintf(c->cabecalho_json, sizeof(c->cabecalho_json),
+        FORMATO_CABECALHO, "application/json", c->tam_json);
+    c->tam_cabecalho_binario = (uint8_t)snprintf(c->cabecalho_binario, sizeof(c->cabecalho_binario),
+        FORMATO_CABECALHO, "application/octet-stream", tam_telemetria);
+
+    c->valido = true;
+    estatisticas_http.montagens++;
+    return c;
+}
+
+// Marca a amostra formatada como desatualizada; a próxima requisição a refaz
+// Chamada após cada leitura dos sensores e a cada mudança de limites ou calibrações
+void invalidar_cache_dados(void) {
+    cache_dados.valido = false;
+}
+
+// O formato binário é escolhido por "?fmt=bin" ou, sem o parâmetro, por
+// "Accept: application/octet-stream"; "?fmt=json" força o JSON
+static bool pede_telemetria_binaria(const requisicao_http_t *req) {
+    char formato[8];
+    if (http_parametro_query(req->query, "fmt", formato, sizeof(formato))) {
+        return strcmp(formato, "bin") == 0;
+    }
+    return req->aceita_binario;
+}
+
+// Endpoint que retorna dados dos sensores em JSON ou no formato binário compacto
+// Usado como alternativa ao /stream por navegadores sem EventSource
+// A resposta sai pronta do cache: nenhuma formatação por requisição
+void rota_dados(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req) {
+    const struct cache_dados_web *c = obter_cache_dados();
+    if (pede_telemetria_binaria(req)) {
+        enviar_resposta_pronta(tpcb, hs, c->cabecalho_binario, c->tam_cabecalho_binario,
+                               c->telemetria, TELEMETRIA_TAMANHO);
+        return;
+    }
+    enviar_resposta_pronta(tpcb, hs, c->cabecalho_json, c->tam_cabecalho_json,
+                           c->quadro_ws + WS_TAM_MAX_CABECALHO, c->tam_json);
+}
+
+// Lê um parâmetro numérico da query; parâmetro ausente mantém '*valor'
+// Retorna false se o parâmetro existir mas não for um número natural
+static bool ler_parametro_natural(const requisicao_http_t *req, const char *nome, uint32_t *valor,
+                                  bool *presente) {
+    char texto[12];
+    *presente = http_parametro_query(req->query, nome, texto, sizeof(texto));
+    if (!*presente) return true;
+    char *fim;
+    unsigned long n = strtoul(texto, &fim, 10);
+    if (texto[0] < '0' || texto[0] > '9' || *fim != '\0') return false;
+    *valor = (uint32_t)n;
+    return true;
+}
+
+// Canais do histórico web, na ordem das colunas da resposta
+// As faixas (_faixa_min, _faixa_max) só saem se pedidas em ?canal: sem ele, o histórico continua
+// do mesmo tamanho. O nome não é temp_min: em /dados e /config esse é o limite de alerta
+static const struct {
+    const char *nome;
+    const int32_t *dados;            // Centésimos
+} CANAIS_HISTORICO[] = {
+    {"temp",  dados_web_temp},
+    {"umid",  dados_web_umid},
+    {"press", dados_web_press},
+    {"temp_faixa_min",  dados_web_temp_faixa_min},
+    {"temp_faixa_max",  dados_web_temp_faixa_max},
+    {"press_faixa_min", dados_web_press_faixa_min},
+    {"press_faixa_max", dados_web_press_faixa_max},
+};
+#define NUM_CANAIS_HISTORICO (sizeof(CANAIS_HISTORICO) / sizeof(CANAIS_HISTORICO[0]))
+#define CANAIS_HISTORICO_PADRAO 0x07u   // temp, umid, press
+
+// Interpreta "canal=temp,press" como máscara de bits de CANAIS_HISTORICO; ausente seleciona os padrão
+// Retorna 0 se algum nome for inválido
+static uint8_t ler_canais_historico(const requisicao_http_t *req) {
+    char lista[HTTP_TAM_QUERY];      // Cabe a query inteira: todos os canais juntos passam de 64 bytes
+    if (!http_parametro_query(req->query, "canal", lista, sizeof(lista))) {
+        return CANAIS_HISTORICO_PADRAO;
+    }
+    uint8_t canais = 0;
+    for (char *nome = strtok(lista, ","); nome; nome = strtok(NULL, ",")) {
+        size_t c = 0;
+        while (c < NUM_CANAIS_HISTORICO && strcmp(nome, CANAIS_HISTORICO[c].nome) != 0) c++;
+        if (c == NUM_CANAIS_HISTORICO) return 0;
+        canais |= 1u << c;
+    }
+    return canais;
+}
+
+// Posição no anel dados_web_* da amostra 'seq', ou -1 se ela já foi sobrescrita
+static int posicao_historico(uint32_t seq) {
+    uint32_t atras = sequencia_web - seq;
+    if (atras >= (uint32_t)contador_web) return -1;
+    return (indice_web + TAMANHO_HISTORICO_WEB - 1 - (int)atras) % TAMANHO_HISTORICO_WEB;
+}
+
+// Etapas da geração de /historico
+enum {
+    HISTORICO_INICIO,       // Metadados e abertura da lista
+    HISTORICO_AMOSTRAS,     // Linhas [seq, valores...]
+    HISTORICO_SERIES,       // Uma série [[seq, valor], ...] por canal (com ?pontos)
+    HISTORICO_CONCLUIDO
+};
+
+// Escreve o próximo pedaço de /historico; cada pedaço termina numa linha completa
+// O anel continua recebendo amostras durante o envio: linhas cujas amostras já
+// foram sobrescritas são puladas (a falta aparece na sequência), nunca trocadas
+static size_t gerar_historico(struct estado_http *hs, char *destino, size_t capacidade) {
+    struct gerador_historico *g = &hs->geracao.historico;
+    escritor_json_t *j = &g->json;
+    if (g->etapa == HISTORICO_CONCLUIDO) return 0;
+    json_continuar(j, destino, capacidade);
+
+    if (g->etapa == HISTORICO_INICIO) {
+        json_abrir_objeto(j);
+        json_membro_natural(j, "intervalo_ms", INTERVALO_LEITURA_MS);
+        json_membro_natural(j, "primeira", g->primeira);
+        json_membro_natural(j, "ultima", g->ultima);
+        if (g->pontos) {
+            json_chave(j, "series");
+            json_abrir_objeto(j);
+            g->etapa = HISTORICO_SERIES;
+        } else {
+            json_chave(j, "campos");
+            json_abrir_lista(j);
+            json_texto(j, "seq");
+            for (size_t c = 0; c < NUM_CANAIS_HISTORICO; c++) {
+                if (g->canais & (1u << c)) json_texto(j, CANAIS_HISTORICO[c].nome);
+            }
+            json_fechar_lista(j);
+            json_chave(j, "amostras");
+            json_abrir_lista(j);
+            g->etapa = HISTORICO_AMOSTRAS;
+        }
+    }
+
+    while (g->etapa == HISTORICO_AMOSTRAS && json_restante(j) >= TAM_LINHA_HISTORICO) {
+        if (g->proxima == g->fim) {
+            json_fechar_lista(j);
+            json_fechar_objeto(j);
+            g->etapa = HISTORICO_CONCLUIDO;
+            break;
+        }
+        int i = posicao_historico(g->proxima++);
+        if (i < 0) continue;
+        json_abrir_lista(j);
+        json_natural(j, g->proxima - 1);
+        for (size_t c = 0; c < NUM_CANAIS_HISTORICO; c++) {
+            if (g->canais & (1u << c)) json_fixo(j, CANAIS_HISTORICO[c].dados[i], 2);
+        }
+        json_fechar_lista(j);
+    }
+
+    // Com ?pontos cada canal escolhe seus próprios pontos: o LTTB é retomado a cada pedaço
+    while (g->etapa == HISTORICO_SERIES && json_restante(j) >= TAM_LINHA_HISTORICO) {
+        if (!g->serie_aberta) {
+            while (g->canal < NUM_CANAIS_HISTORICO && !(g->canais & (1u << g->canal))) g->canal++;
+            if (g->canal == NUM_CANAIS_HISTORICO) {
+                json_fechar_objeto(j);
+                json_fechar_objeto(j);
+                g->etapa = HISTORICO_CONCLUIDO;
+                break;
+            }
+            serie_circular_t serie = {CANAIS_HISTORICO[g->canal].dados, TAMANHO_HISTORICO_WEB,
+                                      g->posicao_inicio, (uint16_t)(g->fim - g->inicio)};
+            lttb_iniciar(&g->lttb, &serie, g->pontos);
+            json_chave(j, CANAIS_HISTORICO[g->canal].nome);
+            json_abrir_lista(j);
+            g->serie_aberta = true;
+        }
+        uint16_t indice;
+        int32_t valor;
+        if (!lttb_proximo(&g->lttb, &indice, &valor)) {
+            json_fechar_lista(j);
+            g->serie_aberta = false;
+            g->canal++;
+            continue;
+        }
+        if (posicao_historico(g->inicio + indice) < 0) continue;
+        json_abrir_lista(j);
+        json_natural(j, g->inicio + indice);
+        json_fixo(j, valor, 2);
+        json_fechar_lista(j);
+    }
+    return json_terminar(j);
+}
+
+// Histórico das últimas amostras (anel dados_web_*), com número de sequência
+// ?since=N   só amostras com seq > N (o que um gráfico reconectando perdeu)
+// ?count=N   no máximo N amostras, sempre as mais recentes: se a falta depois de
+//            'since' for maior que N, a parte mais antiga dela fica de fora
+// ?canal=... colunas desejadas: temp, umid, press (padrão) e as faixas de cada intervalo,
+//            temp_faixa_min, temp_faixa_max, press_faixa_min, press_faixa_max
+// ?pontos=N  reduz o trecho a N pontos por canal com LTTB (para gráficos estreitos)
+// Resposta: {"intervalo_ms":..,"primeira":..,"ultima":..,"campos":["seq",..],"amostras":[[seq,..],..]}
+// Com 'pontos' cada canal escolhe seus próprios pontos, então em vez de "campos"/"amostras"
+// vem uma série por canal: "series":{"temp":[[seq,valor],..],..}
+// O corpo é gerado aos pedaços (gerar_historico), sem buffer do tamanho da resposta
+void rota_historico(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req) {
+    uint32_t desde = 0, quantidade = TAMANHO_HISTORICO_WEB, pontos = 0;
+    bool tem_desde, tem_quantidade, reduzir;
+    uint8_t canais = ler_canais_historico(req);
+    if (!ler_parametro_natural(req, "since", &desde, &tem_desde) ||
+        !ler_parametro_natural(req, "count", &quantidade, &tem_quantidade) ||
+        !ler_parametro_natural(req, "pontos", &pontos, &reduzir) || canais == 0) {
+        enviar_status_http(tpcb, hs, 400);
+        return;
+    }
+
+    // Sequências disponíveis no anel: [primeira, ultima]
+    uint32_t ultima = sequencia_web;
+    uint32_t primeira = ultima - (uint32_t)contador_web + 1;
+    uint32_t inicio = (tem_desde && desde >= primeira) ? desde + 1 : primeira;
+    uint32_t disponiveis = (tem_desde && desde >= ultima) ? 0 : ultima - inicio + 1;
+    if (quantidade > disponiveis) quantidade = disponiveis;
+    inicio = ultima - quantidade + 1;                         // As mais recentes, com ou sem 'since'
+
+    struct gerador_historico *g = &hs->geracao.historico;
+    memset(g, 0, sizeof(*g));
+    g->primeira = contador_web ? primeira : 0;
+    g->ultima = ultima;
+    g->inicio = g->proxima = inicio;
+    g->fim = inicio + quantidade;
+    if (quantidade > 0) g->posicao_inicio = (uint16_t)posicao_historico(inicio);
+    g->pontos = !reduzir ? 0 : (pontos < 3) ? 3 : (pontos > UINT16_MAX) ? UINT16_MAX : (uint16_t)pontos;
+    g->canais = canais;
+    g->etapa = HISTORICO_INICIO;
+    enviar_resposta_gerada(tpcb, hs, req, "application/json", "Cache-Control: no-store\r\n", gerar_historico);
+}
+
+// Envia um evento "data:" com a amostra atual a um assinante de /stream
+// Se o buffer de envio não comporta o evento inteiro, esta amostra é descartada
+// para esse cliente: a próxima trará valores mais novos de qualquer forma
+static void enviar_evento_sse(struct tcp_pcb *tpcb, struct estado_http *hs, const char *evento, int tamanho) {
+    if (tcp_sndbuf(tpcb) < tamanho ||
+        tcp_write(tpcb, evento, tamanho, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+        estatisticas_http.descartes_sse++;
+        return;
+    }
+    hs->pendente += tamanho;
+    hs->ociosidade = 0;
+    estatisticas_http.eventos_sse++;
+    tcp_output(tpcb);
+}
+
+// Abre um fluxo de eventos (Server-Sent Events) que recebe cada nova amostra
+// A resposta não tem Content-Length: fica aberta até o cliente fechar
+void rota_stream(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req) {
+    static const char cabecalho[] =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/event-stream\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n"
+        "retry: " TEXTO_MACRO(RECONEXAO_SSE_MS) "\n\n";
+
+    if (!reservar_envio_http(tpcb, hs, sizeof(cabecalho) - 1, 1)) return;
+    // Constante na flash: sem cópia
+    if (!escrever_trecho_http(tpcb, hs, cabecalho, sizeof(cabecalho) - 1, 0, true)) return;
+    hs->fluxo_eventos = true;
+    hs->fechar_apos_envio = false;
+    estatisticas_http.assinantes_sse++;
+
+    // Primeiro evento com a amostra atual, para a página não esperar a próxima leitura
+    const struct cache_dados_web *c = obter_cache_dados();
+    enviar_evento_sse(tpcb, hs, c->evento_sse, c->tam_evento);
+}
+
+// Torna 'nova' a configuração em vigor, de uma vez só (config_aplicar)
+// O estado de alerta é reavaliado na próxima volta do loop principal, sem esperar a
+// próxima leitura; os ajustes de calibração valem a partir da próxima coleta do núcleo 1
+// Páginas abertas em /stream e /ws recebem a amostra com os novos valores
+static void aplicar_configuracao(const configuracao_t *nova) {
+    config_aplicar(nova);
+    instante_alteracao_config = to_ms_since_boot(get_absolute_time());
+    config_nao_salva = true;                     // Gravada na flash pelo loop principal
+    reavaliar_alertas = true;                    // LEDs e buzzer não mudam dentro do callback
+    invalidar_cache_dados();
+    difundir_amostra();
+}
+
+// Altera os campos presentes num objeto JSON ou numa query string ("temp_min=20&...")
+// Campos ausentes ficam como estão; se algum for desconhecido, inválido, fora da faixa
+// ou deixar um mínimo acima do máximo, nada muda e 'erro' diz o motivo
+static bool alterar_configuracao(const char *texto, size_t tamanho, bool json, erro_config_t *erro) {
+    configuracao_t nova = config_atual;
+    bool lido = json ? config_ler_json(&nova, texto, tamanho, erro) : config_ler_query(&nova, texto, erro);
+    if (!lido || !config_validar(&nova, erro)) return false;
+    aplicar_configuracao(&nova);
+    return true;
+}
+
+// Resultado de uma alteração: {"ok":..,"versao":..} e, na falha, "erro" e "campo"
+static size_t escrever_resultado_config(escritor_json_t *j, const erro_config_t *erro) {
+    bool ok = (erro->resultado == CONFIG_OK);
+    json_chave(j, "ok");
+    json_booleano(j, ok);
+    json_membro_natural(j, "versao", versao_config);
+    if (!ok) {
+        json_chave(j, "erro");
+        json_texto(j, config_descrever(erro->resultado));
+        if (erro->campo[0]) {
+            json_chave(j, "campo");
+            json_texto(j, erro->campo);
+        }
+    }
+    json_fechar_objeto(j);
+    return json_terminar(j);
+}
+
+// Configuração do sistema, descrita pela tabela de lib/configuracao.h
+// GET:  {"versao":..,"valores":{"temp_min":..,..},"esquema":{"temp_min":{"tipo","min","max","padrao","unidade"},..}}
+// POST: objeto JSON só com os campos a alterar, ex.: {"temp_min":18.5,"temp_max":27}
+//       Com "versao" no objeto, a alteração só é aceita se ninguém mudou a configuração antes (409)
+void rota_config(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req) {
+    static char resposta[TAM_RESPOSTA_HTTP];
+    escritor_json_t j;
+    json_iniciar(&j, resposta, sizeof(resposta));
+    json_abrir_objeto(&j);
+
+    if (req->metodo == METODO_HTTP_GET) {
+        json_membro_natural(&j, "versao", versao_config);
+        json_chave(&j, "valores");
+        json_abrir_objeto(&j);
+        config_escrever_valores(&j, &config_atual);
+        json_fechar_objeto(&j);
+        json_chave(&j, "esquema");
+        json_abrir_objeto(&j);
+        config_escrever_esquema(&j);
+        json_fechar_objeto(&j);
+        json_fechar_objeto(&j);
+        size_t tam = json_terminar(&j);
+        enviar_resposta_http(tpcb, hs, "application/json", "Cache-Control: no-store\r\n", resposta, tam, false);
+        return;
+    }
+
+    erro_config_t erro;
+    alterar_configuracao(corpo_http, tam_corpo_http, true, &erro);
+    uint16_t status = (erro.resultado == CONFIG_OK) ? 200
+                    : (erro.resultado == CONFIG_VERSAO_DIVERGENTE) ? 409 : 400;
+    size_t tam = escrever_resultado_config(&j, &erro);
+    enviar_resposta_status_http(tpcb, hs, status, "application/json", "", resposta, tam, false);
+}
+
+// Endpoints antigos, mantidos para clientes que usam GET com query string
+// Aceitam os mesmos campos de /config; os ausentes não mudam
+void rota_set_limits(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req) {
+    erro_config_t erro;
+    if (!alterar_configuracao(req->query, strlen(req->query), false, &erro)) {
+        enviar_status_http(tpcb, hs, 400);
+        return;
+    }
+    // Resposta simples confirmando alteração
+    const char *resposta = "Limites atualizados";
+    enviar_resposta_http(tpcb, hs, "text/plain", "", resposta, strlen(resposta), false);
+}
+
+void rota_set_offsets(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req) {
+    erro_config_t erro;
+    if (!alterar_configuracao(req->query, strlen(req->query), false, &erro)) {
+        enviar_status_http(tpcb, hs, 400);
+        return;
+    }
+    const char *resposta = "Calibracoes atualizadas";
+    enviar_resposta_http(tpcb, hs, "text/plain", "", resposta, strlen(resposta), false);
+}
+
+// Envia um quadro WebSocket do servidor (sem máscara, FIN = 1)
+// 'quadro' reserva WS_TAM_MAX_CABECALHO bytes antes do payload: o cabeçalho é
+// escrito encostado no payload para que o quadro saia inteiro numa única tcp_write
+// Retorna false, sem enviar nada, se o quadro não couber no buffer de envio
+static bool enviar_quadro_ws(struct tcp_pcb *tpcb, struct estado_http *hs, uint8_t opcode,
+                             uint8_t *quadro, uint16_t tamanho) {
+    uint8_t cabecalho[WS_TAM_MAX_CABECALHO];
+    size_t tam_cabecalho = websocket_cabecalho_quadro(cabecalho, opcode, tamanho);
+    uint8_t *inicio = quadro + WS_TAM_MAX_CABECALHO - tam_cabecalho;
+    memcpy(inicio, cabecalho, tam_cabecalho);
+
+    u16_t total = (u16_t)(tam_cabecalho + tamanho);
+    if (tcp_sndbuf(tpcb) < total || tcp_write(tpcb, inicio, total, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+        return false;
+    }
+    hs->pendente += total;
+    hs->ociosidade = 0;
+    tcp_output(tpcb);
+    return true;
+}
+
+// Envia a amostra (JSON já montado depois do espaço do cabeçalho) a um cliente WebSocket
+// Como no SSE, a amostra é descartada para esse cliente se o buffer estiver cheio
+static void enviar_amostra_ws(struct tcp_pcb *tpcb, struct estado_http *hs, uint8_t *quadro, uint16_t tamanho) {
+    if (enviar_quadro_ws(tpcb, hs, WS_OPCODE_TEXTO, quadro, tamanho)) {
+        estatisticas_http.eventos_ws++;
+    } else {
+        estatisticas_http.descartes_ws++;
+    }
+}
+
+// Promove a conexão a WebSocket (RFC 6455, seção 4.2)
+// Depois do 101 a conexão não atende mais requisições HTTP: passa a receber as
+// amostras e a aceitar os comandos "set_limits?..." e "set_offsets?..."
+void rota_ws(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req) {
+    if (req->versao_websocket != 13) {
+        enviar_status_http(tpcb, hs, req->upgrade_websocket ? 426 : 400);
+        return;
+    }
+    if (!req->upgrade_websocket || !req->conexao_upgrade || strlen(req->chave_websocket) != WS_TAM_CHAVE) {
+        enviar_status_http(tpcb, hs, 400);
+        return;
+    }
+
+    // O aceite é calculado antes de iniciar o decodificador, que reaproveita a memória de 'req'
+    char aceite[WS_TAM_ACEITE + 1];
+    websocket_calcular_aceite(req->chave_websocket, aceite);
+
+    char cabecalho[160];
+    int tam_cabecalho = snprintf(cabecalho, sizeof(cabecalho),
+        "HTTP/1.1 101 Switching Protocols\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Accept: %s\r\n"
+        "\r\n",
+        aceite);
+
+    if (!reservar_envio_http(tpcb, hs, tam_cabecalho, 1)) return;
+    if (!escrever_trecho_http(tpcb, hs, cabecalho, tam_cabecalho, TCP_WRITE_FLAG_COPY, true)) return;
+    websocket_iniciar(&hs->ws);
+    hs->websocket = true;
+    hs->fechar_apos_envio = false;
+    estatisticas_http.assinantes_ws++;
+
+    // Primeira amostra logo após o handshake, como no /stream
+    obter_cache_dados();
+    enviar_amostra_ws(tpcb, hs, cache_dados.quadro_ws, cache_dados.tam_json);
+}
+
+// Envia a amostra atual a todos os assinantes de /stream e de /ws
+// Os bytes vêm prontos do cache e são copiados para cada conexão
+static void difundir_amostra(void) {
+    obter_cache_dados();
+    for (int i = 0; i < MAX_CONEXOES_HTTP; i++) {
+        struct estado_http *hs = &conexoes_http[i];
+        if (!hs->pcb) continue;
+        if (hs->fluxo_eventos) {
+            enviar_evento_sse(hs->pcb, hs, cache_dados.evento_sse, cache_dados.tam_evento);
+        } else if (hs->websocket && !hs->fechar_apos_envio) {
+            enviar_amostra_ws(hs->pcb, hs, cache_dados.quadro_ws, cache_dados.tam_json);
+        }
+    }
+}
+
+// Executa um comando de texto recebido por WebSocket e responde ao remetente
+// Aceita um objeto JSON com os campos a alterar, como o corpo de POST /config,
+// ou o formato das rotas GET antigas: "set_limits?temp_min=20&..."
+// A alteração já chega a todos os clientes como amostra (aplicar_configuracao)
+static void executar_comando_ws(struct tcp_pcb *tpcb, struct estado_http *hs, char *mensagem) {
+    const char *comando = "desconhecido";
+    erro_config_t erro = { .resultado = CONFIG_FORMATO_INVALIDO };
+    char *parametros = strchr(mensagem, '?');
+    if (mensagem[0] == '{') {
+        comando = "config";
+        alterar_configuracao(mensagem, strlen(mensagem), true, &erro);
+    } else if (parametros) {
+        *parametros++ = '\0';
+        if (strcmp(mensagem, "set_limits") == 0 || strcmp(mensagem, "set_offsets") == 0) {
+            comando = mensagem;
+            alterar_configuracao(parametros, strlen(parametros), false, &erro);
+        }
+    }
+    estatisticas_http.comandos_ws++;
+
+    uint8_t quadro[WS_TAM_MAX_CABECALHO + 160];
+    escritor_json_t j;
+    json_iniciar(&j, (char *)quadro + WS_TAM_MAX_CABECALHO, sizeof(quadro) - WS_TAM_MAX_CABECALHO);
+    json_abrir_objeto(&j);
+    json_chave(&j, "comando");
+    json_texto(&j, comando);
+    size_t tam = escrever_resultado_config(&j, &erro);
+    enviar_quadro_ws(tpcb, hs, WS_OPCODE_TEXTO, quadro, (uint16_t)tam);
+}
+
+// Envia o quadro de fechamento com o código dado e fecha a conexão quando ele for confirmado
+static void fechar_websocket(struct tcp_pcb *tpcb, struct estado_http *hs, uint16_t codigo) {
+    uint8_t quadro[WS_TAM_MAX_CABECALHO + 2];
+    quadro[WS_TAM_MAX_CABECALHO] = (uint8_t)(codigo >> 8);
+    quadro[WS_TAM_MAX_CABECALHO + 1] = (uint8_t)codigo;
+    enviar_quadro_ws(tpcb, hs, WS_OPCODE_FECHAR, quadro, 2);
+    hs->fechar_apos_envio = true;
+}
+
+// Decodifica os quadros recebidos numa conexão WebSocket, direto dos segmentos
+// da cadeia, do mesmo modo que as requisições HTTP são analisadas
+static void processar_quadros_websocket(struct tcp_pcb *tpcb, struct estado_http *hs) {
+    while (hs->recebido && !hs->fechar_apos_envio) {
+        // Respostas e pongs precisam de espaço no buffer de envio
+        if (tcp_sndbuf(tpcb) < RESERVA_ENVIO_HTTP) break;
+
+        resultado_ws_t resultado = WS_INCOMPLETO;
+        while (hs->recebido && resultado == WS_INCOMPLETO) {
+            size_t usados;
+            resultado = websocket_consumir(&hs->ws, hs->recebido->payload, hs->recebido->len, &usados);
+            if (usados == 0) break;
+            hs->recebido = pbuf_free_header(hs->recebido, (u16_t)usados);
+            tcp_recved(tpcb, (u16_t)usados);
+        }
+        hs->ociosidade = 0;
+
+        switch (resultado) {
+            case WS_MENSAGEM:
+                executar_comando_ws(tpcb, hs, hs->ws.mensagem);
+                break;
+            case WS_PING: {
+                // Pong repete o payload do ping
+                uint8_t quadro[WS_TAM_MAX_CABECALHO + WS_TAM_CONTROLE];
+                memcpy(quadro + WS_TAM_MAX_CABECALHO, hs->ws.controle, hs->ws.tamanho_controle);
+                enviar_quadro_ws(tpcb, hs, WS_OPCODE_PONG, quadro, hs->ws.tamanho_controle);
+                break;
+            }
+            case WS_FECHAR:                              // Ecoa o código recebido
+            case WS_ERRO:                                // Código do erro de protocolo
+                fechar_websocket(tpcb, hs, hs->ws.codigo);
+                break;
+            default:
+                return;                                  // Espera o próximo segmento
+        }
+    }
+}
+
+// Ocupação dos slots, contadores do servidor HTTP e acessos por rota
+void rota_estatisticas(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req) {
+    const struct estatisticas_servidor *e = &estatisticas_http;
+    static char payload_json[TAM_RESPOSTA_HTTP];
+    escritor_json_t j;
+    json_iniciar(&j, payload_json, sizeof(payload_json));
+    json_abrir_objeto(&j);
+    json_membro_natural(&j, "slots", MAX_CONEXOES_HTTP);
+    json_membro_natural(&j, "ocupados", MAX_CONEXOES_HTTP - num_slots_livres);
+    json_membro_natural(&j, "pico_ocupados", e->pico_ocupados);
+    json_membro_natural(&j, "aceitas", e->aceitas);
+    json_membro_natural(&j, "rejeitadas", e->rejeitadas);
+    json_membro_natural(&j, "erros", e->erros);
+    json_membro_natural(&j, "expiradas", e->expiradas);
+    json_membro_natural(&j, "revalidadas", e->revalidadas);
+    json_membro_natural(&j, "assinantes_sse", e->assinantes_sse);
+    json_membro_natural(&j, "eventos_sse", e->eventos_sse);
+    json_membro_natural(&j, "descartes_sse", e->descartes_sse);
+    json_membro_natural(&j, "assinantes_ws", e->assinantes_ws);
+    json_membro_natural(&j, "eventos_ws", e->eventos_ws);
+    json_membro_natural(&j, "descartes_ws", e->descartes_ws);
+    json_membro_natural(&j, "comandos_ws", e->comandos_ws);
+    json_membro_natural(&j, "montagens", e->montagens);
+
+    json_chave(&j, "rotas");
+    json_abrir_objeto(&j);
+    const tabela_rotas_http_t *tabela = &TABELA_ROTAS_HTTP;
+    for (uint8_t i = 0; i < tabela->num_rotas; i++) {
+        json_membro_natural(&j, tabela->rotas[i].caminho, tabela->acessos[i]);
+    }
+    json_membro_natural(&j, "outras", e->sem_rota);
+    json_fechar_objeto(&j);
+
+    // Área de registros na flash: gravações e quanto tempo o XIP ficou parado
+    const estatisticas_registro_t *f = &estatisticas_registro;
+    json_chave(&j, "flash");
+    json_abrir_objeto(&j);
+    json_membro_natural(&j, "gravacoes", f->gravacoes);
+    json_membro_natural(&j, "ignoradas", f->ignoradas);
+    json_membro_natural(&j, "apagamentos", f->apagamentos);
+    json_membro_natural(&j, "falhas", f->falhas);
+    json_membro_natural(&j, "descartados", f->descartados);
+    json_membro_natural(&j, "setor", f->setor);
+    json_membro_natural(&j, "ocupados", f->ocupados);
+    json_membro_natural(&j, "varredura_us", f->varredura_us);
+    json_membro_natural(&j, "ultimo_bloqueio_us", f->ultimo_bloqueio_us);
+    json_membro_natural(&j, "pior_programacao_us", f->pior_programacao_us);
+    json_membro_natural(&j, "pior_apagamento_us", f->pior_apagamento_us);
+    json_fechar_objeto(&j);
+
+    // Aquisição no núcleo 1: amostras, descartes com a fila cheia e pior atraso da cadência
+    json_chave(&j, "aquisicao");
+    json_abrir_objeto(&j);
+    json_membro_natural(&j, "amostras", amostras_coletadas);
+    json_membro_natural(&j, "descartadas", fila_amostras.descartadas);
+    json_membro_natural(&j, "fila", fila_amostras_ocupacao(&fila_amostras));
+    json_membro_natural(&j, "pior_atraso_us", pior_atraso_coleta_us);
+    json_fechar_objeto(&j);
+
+    // Barramentos I2C: transações, falhas e fração do tempo ocupado (em ‰), e por dispositivo
+    // a latência do enfileiramento ao fim da transação
+    json_chave(&j, "i2c");
+    json_abrir_objeto(&j);
+    static const char *const NOMES_I2C[] = {"sensores", "display"};
+    i2c_inst_t *const PORTAS_I2C[] = {I2C_SENSORES_PORT, I2C_DISPLAY_PORT};
+    for (int i = 0; i < 2; i++) {
+        const estatisticas_barramento_t *b = barramento_estatisticas(PORTAS_I2C[i]);
+        if (!b) continue;
+        json_chave(&j, NOMES_I2C[i]);
+        json_abrir_objeto(&j);
+        json_membro_natural(&j, "transacoes", b->transacoes);
+        json_membro_natural(&j, "nacks", b->nacks);
+        json_membro_natural(&j, "erros", b->erros);
+        json_membro_natural(&j, "bytes", b->bytes);
+        json_membro_natural(&j, "fila", b->fila);
+        json_membro_natural(&j, "maior_fila", b->maior_fila);
+        json_membro_natural(&j, "coalescidas", b->coalescidas);
+        json_membro_natural(&j, "ocupacao_permil", barramento_ocupacao_permil(PORTAS_I2C[i]));
+        json_membro_natural(&j, "frequencia_hz", barramento_frequencia(PORTAS_I2C[i]));
+        json_chave(&j, "dispositivos");
+        json_abrir_lista(&j);
+        const estatisticas_dispositivo_t *d;
+        const char *nome;
+        uint8_t endereco;
+        for (uint k = 0; (d = barramento_dispositivo(PORTAS_I2C[i], k, &nome, &endereco)) != NULL; k++) {
+            json_abrir_objeto(&j);
+            json_chave(&j, "nome");
+            json_texto(&j, nome);
+            json_membro_natural(&j, "endereco", endereco);
+            json_membro_natural(&j, "transacoes", d->transacoes);
+            json_membro_natural(&j, "nacks", d->nacks);
+            json_membro_natural(&j, "erros", d->erros);
+            json_membro_natural(&j, "prazos_perdidos", d->prazos_perdidos);
+            json_membro_natural(&j, "latencia_media_us", d->transacoes ? (uint32_t)(d->soma_latencia_us / d->transacoes) : 0);
+            json_membro_natural(&j, "latencia_maxima_us", d->maior_latencia_us);
+            json_fechar_objeto(&j);
+        }
+        json_fechar_lista(&j);
+        json_fechar_objeto(&j);
+    }
+    json_fechar_objeto(&j);
+    json_fechar_objeto(&j);
+    int tam_json = (int)json_terminar(&j);
+    enviar_resposta_http(tpcb, hs, "application/json", "", payload_json, tam_json, false);
+}
+
+// Escolhe a rota da requisição já analisada e gera a resposta
+static void processar_requisicao(struct tcp_pcb *tpcb, struct estado_http *hs, const requisicao_http_t *req) {
+    // Decide se a conexão continua aberta depois desta resposta:
+    // HTTP/1.1 mantém por padrão, HTTP/1.0 só se o cliente pedir explicitamente
+    hs->requisicoes++;
+    if (req->conexao == CONEXAO_HTTP_FECHAR ||
+        (req->versao_menor == 0 && req->conexao != CONEXAO_HTTP_MANTER) ||
+        hs->requisicoes >= MAX_REQUISICOES_CONEXAO) {
+        hs->fechar_apos_envio = true;
+    }
+
+    // Busca em tempo constante na tabela gerada a partir de rotas_http.def
+    uint8_t i = buscar_rota_http(&TABELA_ROTAS_HTTP, req->caminho);
+    if (i == ROTA_HTTP_INEXISTENTE) {
+        // Qualquer outra URL serve a página principal
+        estatisticas_http.sem_rota++;
+        if (req->metodo != METODO_HTTP_GET) {
+            enviar_status_http(tpcb, hs, 405);
+            return;
+        }
+        rota_pagina_inicial(tpcb, hs, req);
+        return;
+    }
+
+    const rota_http_t *rota = &TABELA_ROTAS_HTTP.rotas[i];
+    TABELA_ROTAS_HTTP.acessos[i]++;
+    if (!(rota->metodos & (1u << req->metodo))) {
+        enviar_status_http(tpcb, hs, 405);
+        return;
+    }
+    rota->tratador(tpcb, hs, req);
+}
+
+// Separa o corpo da requisição (Content-Length bytes) do início da cadeia recebida
+// Retorna false enquanto ele não chegou inteiro; os bytes ficam na cadeia até lá
+static bool separar_corpo_http(struct tcp_pcb *tpcb, struct estado_http *hs) {
+    u16_t tamanho = (u16_t)hs->req.content_length;
+    if (tamanho > 0) {
+        if (!hs->recebido || hs->recebido->tot_len < tamanho) return false;
+        pbuf_copy_partial(hs->recebido, corpo_http, tamanho, 0);
+        hs->recebido = pbuf_free_header(hs->recebido, tamanho);
+        tcp_recved(tpcb, tamanho);
+    }
+    corpo_http[tamanho] = '\0';
+    tam_corpo_http = tamanho;
+    return true;
+}
+
+// Atende, em ordem, as requisições já recebidas nesta conexão (pipelining)
+// Uma nova resposta só começa quando o corpo da anterior foi todo entregue ao lwIP
+static err_t processar_requisicoes_pendentes(struct tcp_pcb *tpcb, struct estado_http *hs) {
+    // Um fluxo de eventos não recebe novas requisições: o que chegar é descartado
+    if (hs->fluxo_eventos && hs->recebido) {
+        tcp_recved(tpcb, hs->recebido->tot_len);
+        pbuf_free(hs->recebido);
+        hs->recebido = NULL;
+    }
+
+    while (hs->recebido && !hs->fechar_apos_envio && !hs->fluxo_eventos && !hs->websocket &&
+           resposta_entregue(hs)) {
+        // Aguarda espaço no buffer de envio para a maior resposta copiada: a requisição só é
+        // consumida quando a resposta pode ser escrita inteira; até lá fica na cadeia e é
+        // retomada por callback_envio_http ou callback_poll_http
+        if (!cabe_no_envio(tpcb, RESERVA_ENVIO_HTTP, 3)) break;
+
+        // Alimenta o analisador com cada segmento da cadeia, direto do payload;
+        // os bytes consumidos são liberados na hora, pois o analisador guarda o estado
+        // Se o cabeçalho já foi analisado numa passagem anterior, falta só o corpo
+        resultado_analise_http_t resultado = hs->aguardando_corpo ? ANALISE_HTTP_COMPLETA
+                                                                  : ANALISE_HTTP_INCOMPLETA;
+        while (hs->recebido && resultado == ANALISE_HTTP_INCOMPLETA) {
+            size_t usados;
+            resultado = analisador_http_consumir(&hs->req, hs->recebido->payload,
+                                                 hs->recebido->len, &usados);
+            if (usados == 0) break;
+            hs->recebido = pbuf_free_header(hs->recebido, (u16_t)usados);
+            tcp_recved(tpcb, (u16_t)usados);
+        }
+        if (resultado == ANALISE_HTTP_INCOMPLETA) break;   // Espera o próximo segmento
+        hs->ociosidade = 0;
+
+        // O corpo precisa caber inteiro no buffer antes de a rota ser chamada
+        if (resultado == ANALISE_HTTP_COMPLETA && hs->req.content_length > TAM_CORPO_HTTP) {
+            hs->req.erro = 413;
+            resultado = ANALISE_HTTP_ERRO;
+        }
+        hs->aguardando_corpo = (resultado == ANALISE_HTTP_COMPLETA && !separar_corpo_http(tpcb, hs));
+        if (hs->aguardando_corpo) break;
+
+        if (resultado == ANALISE_HTTP_ERRO) {
+            enviar_status_http(tpcb, hs, hs->req.erro);
+        } else {
+            processar_requisicao(tpcb, hs, &hs->req);
+        }
+        if (!hs->websocket) analisador_http_iniciar(&hs->req);   // Após o upgrade, 'ws' ocupa o lugar de 'req'
+    }
+
+    // Resposta truncada: o cliente não teria como saber onde ela termina
+    if (hs->abortar) return abortar_conexao_http(tpcb, hs);
+
+    // Conexão promovida a WebSocket: o que chegar depois do handshake são quadros
+    if (hs->websocket) processar_quadros_websocket(tpcb, hs);
+
+    // Última resposta entregue e confirmada: encerra se não for manter a conexão
+    if (hs->fechar_apos_envio && resposta_entregue(hs) && hs->pendente == 0) {
+        return encerrar_conexao_http(tpcb, hs);
+    }
+    return ERR_OK;
+}
+
 // Função chamada quando dados são enviados com sucesso via TCP
-// Serve para controlar o progresso do envio e fechar a conexão quando terminar
+// Serve para controlar o progresso do envio e atender requisições enfileiradas
 static err_t callback_envio_http(void *arg, struct tcp_pcb *tpcb, u16_t len) {
     struct estado_http *hs = (struct estado_http *)arg; // Recupera estado da conexão
-    hs->enviado += len;                                 // Atualiza quantos bytes foram enviados
-    
-    // Se enviou tudo, fecha a conexão e libera memória
-    if (hs->enviado >= hs->tamanho) {
-        tcp_close(tpcb);   // Fecha conexão TCP
-        free(hs);          // Libera memória alocada para esta conexão
+    hs->pendente -= len;                                // Bytes confirmados pelo cliente
+
+    // Continua o envio do corpo a partir do cursor
+    enviar_proximo_trecho(tpcb, hs);
+    return processar_requisicoes_pendentes(tpcb, hs);
+}
+
+// Chamado periodicamente pelo lwIP (a cada ~1s) enquanto a conexão existe
+// Retoma envios que falharam por falta de memória e fecha conexões ociosas
+static err_t callback_poll_http(void *arg, struct tcp_pcb *tpcb) {
+    struct estado_http *hs = (struct estado_http *)arg;
+    if (!hs) {
+        tcp_abort(tpcb);
+        return ERR_ABRT;
+    }
+
+    enviar_proximo_trecho(tpcb, hs);
+    err_t resultado = processar_requisicoes_pendentes(tpcb, hs);
+    if (resultado != ERR_OK) return resultado;
+
+    // Fluxo de eventos parado (sem amostras): envia um comentário SSE para manter
+    // a conexão viva e detectar clientes que sumiram sem fechar
+    if (hs->fluxo_eventos) {
+        if (++hs->ociosidade >= TEMPO_OCIOSO_HTTP_S && tcp_sndbuf(tpcb) > 2) {
+            if (tcp_write(tpcb, ":\n\n", 3, 0) == ERR_OK) {
+                hs->pendente += 3;
+                hs->ociosidade = 0;
+                tcp_output(tpcb);
+            }
+        }
+        return ERR_OK;
+    }
+
+    // No WebSocket o equivalente é um ping vazio (o navegador responde com pong)
+    if (hs->websocket) {
+        if (!hs->fechar_apos_envio && ++hs->ociosidade >= TEMPO_OCIOSO_HTTP_S) {
+            uint8_t quadro[WS_TAM_MAX_CABECALHO];
+            enviar_quadro_ws(tpcb, hs, WS_OPCODE_PING, quadro, 0);
+        }
+        return ERR_OK;
+    }
+
+    // Conta o tempo sem atividade apenas quando não há resposta em andamento
+    if (hs->pendente == 0 && resposta_entregue(hs)) {
+        if (++hs->ociosidade >= TEMPO_OCIOSO_HTTP_S) {
+            estatisticas_http.expiradas++;
+            return encerrar_conexao_http(tpcb, hs);
+        }
     }
-    return ERR_OK; // Retorna sucesso
+    return ERR_OK;
 }
 
-// Função principal que processa requisições HTTP recebidas
-// Analisa a URL requisitada e gera a resposta apropriada
+// Chamado pelo lwIP quando a conexão é resetada ou abortada
+// O PCB já foi liberado pela pilha; resta apenas devolver o slot
+static void callback_erro_http(void *arg, err_t err) {
+    struct estado_http *hs = (struct estado_http *)arg;
+    if (hs) {
+        estatisticas_http.erros++;
+        liberar_slot_http(hs);
+    }
+}
+
+// Função chamada quando chegam dados de uma conexão
+// Acumula os segmentos e atende as requisições completas em ordem
 static err_t callback_recepcao_http(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    struct estado_http *hs = (struct estado_http *)arg;
+
     // Se não há dados, cliente fechou conexão
-    if (!p) { 
-        tcp_close(tpcb); 
-        return ERR_OK; 
-    }
-    
-    char *requisicao = (char *)p->payload; // Extrai texto da requisição HTTP
-    
-    // Aloca memória para estado desta conexão
-    struct estado_http *hs = malloc(sizeof(struct estado_http));
-    if (!hs) { // Se não conseguiu alocar, fecha conexão
-        pbuf_free(p); 
-        tcp_close(tpcb); 
-        return ERR_MEM; 
-    }
-    hs->enviado = 0; // Inicializa contador de bytes enviados
-    
-    // Analisa qual endpoint foi requisitado e gera resposta apropriada
-    if (strstr(requisicao, "GET /dados")) {
-        // Endpoint que retorna dados dos sensores em formato JSON
-        // Usado pela interface web para atualizar valores em tempo real
-        char payload_json[768];
-        int tam_json = snprintf(payload_json, sizeof(payload_json),
-            "{\"temp_aht\":%.2f,\"temp_bmp\":%.2f,\"temp_media\":%.2f,\"umidade\":%.2f,\"pressao\":%.2f,"
-            "\"temp_min\":%.2f,\"temp_max\":%.2f,\"umid_min\":%.2f,\"umid_max\":%.2f,"
-            "\"press_min\":%.2f,\"press_max\":%.2f,"
-            "\"offset_temp_aht\":%.2f,\"offset_temp_bmp\":%.2f,\"offset_umid\":%.2f,\"offset_press\":%.2f}",
-            temp_aht, temp_bmp, temp_media, umidade_atual, pressao_atual / 100.0f,
-            limite_temp_min, limite_temp_max, limite_umid_min, limite_umid_max,
-            limite_press_min, limite_press_max, 
-            ajuste_temp_aht, ajuste_temp_bmp, ajuste_umidade, ajuste_pressao);
-            
-        // Monta cabeçalho HTTP + JSON
-        hs->tamanho = snprintf(hs->resposta, sizeof(hs->resposta),
-            "HTTP/1.1 200 OK\r\n"                  // Status de sucesso
-            "Content-Type: application/json\r\n"   // Tipo de conteúdo
-            "Content-Length: %d\r\n"               // Tamanho do conteúdo
-            "Connection: close\r\n"                // Fecha conexão após envio
-            "\r\n"                                 // Linha em branco (fim do cabeçalho)
-            "%s", tam_json, payload_json);         // Conteúdo JSON
-    }
-    else if (strstr(requisicao, "GET /set_limits")) {
-        // Endpoint para configurar novos limites de alerta via web
-        // Extrai parâmetros da URL usando sscanf
-        float temp_min, temp_max, umid_min, umid_max, press_min, press_max;
-        sscanf(requisicao, "GET /set_limits?temp_min=%f&temp_max=%f&umid_min=%f&umid_max=%f&press_min=%f&press_max=%f",
-            &temp_min, &temp_max, &umid_min, &umid_max, &press_min, &press_max);
-        // Atualiza variáveis globais com novos limites
-        limite_temp_min = temp_min; limite_temp_max = temp_max;
-        limite_umid_min = umid_min; limite_umid_max = umid_max;
-        limite_press_min = press_min; limite_press_max = press_max;    
-        // Resposta simples confirmando alteração
-        const char *resposta = "Limites atualizados";
-        hs->tamanho = snprintf(hs->resposta, sizeof(hs->resposta),
-            "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
-            (int)strlen(resposta), resposta);
-    }
-    else if (strstr(requisicao, "GET /set_offsets")) {
-        // Endpoint para configurar valores de calibração dos sensores
-        float offset_temp_aht, offset_temp_bmp, offset_umid, offset_press;
-        sscanf(requisicao, "GET /set_offsets?offset_temp_aht=%f&offset_temp_bmp=%f&offset_umid=%f&offset_press=%f",
-            &offset_temp_aht, &offset_temp_bmp, &offset_umid, &offset_press);
-            
-        // Atualiza variáveis de calibração
-        ajuste_temp_aht = offset_temp_aht; ajuste_temp_bmp = offset_temp_bmp;
-        ajuste_umidade = offset_umid; ajuste_pressao = offset_press;
-        
-        const char *resposta = "Calibracoes atualizadas";
-        hs->tamanho = snprintf(hs->resposta, sizeof(hs->resposta),
-            "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
-            (int)strlen(resposta), resposta);
-    }
-    else if (strstr(requisicao, "GET /graficos")) {
-        // Página web com gráficos interativos (HTML + JavaScript)
-        hs->tamanho = snprintf(hs->resposta, sizeof(hs->resposta),
-            "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
-            (int)strlen(HTML_GRAFICOS), HTML_GRAFICOS);
-    }
-    else if (strstr(requisicao, "GET /estados")) {
-        // Página web mostrando estados do sistema e alertas
-        hs->tamanho = snprintf(hs->resposta, sizeof(hs->resposta),
-            "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
-            (int)strlen(HTML_ESTADOS), HTML_ESTADOS);
-    }
-    else if (strstr(requisicao, "GET /limites")) {
-        // Página web para configurar limites de alerta
-        hs->tamanho = snprintf(hs->resposta, sizeof(hs->resposta),
-            "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
-            (int)strlen(HTML_LIMITES), HTML_LIMITES);
-    }
-    else if (strstr(requisicao, "GET /calibracao")) {
-        // Página web para ajustar calibração dos sensores
-        hs->tamanho = snprintf(hs->resposta, sizeof(hs->resposta),
-            "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
-            (int)strlen(HTML_CALIBRACAO), HTML_CALIBRACAO);
-    }
-    else {
-        // Qualquer outra URL serve a página principal
-        hs->tamanho = snprintf(hs->resposta, sizeof(hs->resposta),
-            "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
-            (int)strlen(HTML_BODY), HTML_BODY);
+    if (!p) {
+        return encerrar_conexao_http(tpcb, hs);
     }
-    
-    // Configura callbacks e envia resposta
-    tcp_arg(tpcb, hs);                       // Associa estado da conexão ao PCB
-    tcp_sent(tpcb, callback_envio_http);     // Define callback para confirmação de envio
-    tcp_write(tpcb, hs->resposta, hs->tamanho, TCP_WRITE_FLAG_COPY); // Envia dados
-    tcp_output(tpcb);                        // Força envio imediato
-    pbuf_free(p);                            // Libera buffer da requisição recebida
-    return ERR_OK;
+    // Encadeia os novos dados ao que ainda não foi processado
+    // A janela só é liberada (tcp_recved) à medida que as requisições são consumidas,
+    // o que limita a fila recebida ao tamanho da janela TCP
+    if (hs->recebido) {
+        pbuf_cat(hs->recebido, p);
+    } else {
+        hs->recebido = p;
+    }
+    return processar_requisicoes_pendentes(tpcb, hs);
 }
 
 // Callback chamado quando uma nova conexão TCP é estabelecida
-// Configura o callback de recepção de dados
+// Reserva um slot para a conexão e configura os callbacks
 static err_t callback_nova_conexao(void *arg, struct tcp_pcb *newpcb, err_t err) {
-    tcp_recv(newpcb, callback_recepcao_http); // Define função para processar dados recebidos
+    if (err != ERR_OK || !newpcb) return ERR_VAL;
+
+    struct estado_http *hs = adquirir_slot_http();
+    if (!hs) {
+        // Sem slot livre: responde 503 imediatamente e fecha, sem consumir memória
+        estatisticas_http.rejeitadas++;
+        tcp_write(newpcb, RESPOSTA_HTTP_503, sizeof(RESPOSTA_HTTP_503) - 1, 0);
+        tcp_output(newpcb);
+        if (tcp_close(newpcb) != ERR_OK) {
+            tcp_abort(newpcb);
+            return ERR_ABRT;
+        }
+        return ERR_OK;
+    }
+    estatisticas_http.aceitas++;
+    hs->pcb = newpcb;
+
+    tcp_arg(newpcb, hs);                         // Associa estado da conexão ao PCB
+    tcp_recv(newpcb, callback_recepcao_http);    // Define função para processar dados recebidos
+    tcp_sent(newpcb, callback_envio_http);       // Define callback para confirmação de envio
+    tcp_poll(newpcb, callback_poll_http, 2);     // Verificação periódica (intervalo de ~1s)
+    tcp_err(newpcb, callback_erro_http);         // Libera o estado se a conexão cair
     return ERR_OK;
 }
 
@@ -317,27 +1648,90 @@ void iniciar_servidor_web(void) {
         printf("Erro ao vincular porta 80\n"); 
         return; 
     }
+    inicializar_slots_http();                    // Todos os slots de conexão começam livres
     pcb = tcp_listen(pcb);                       // Coloca servidor em modo de escuta
     tcp_accept(pcb, callback_nova_conexao);      // Define callback para novas conexões
     printf("Servidor HTTP ativo na porta 80\n");
 }
 
+// Envia a amostra recém-coletada a todos os assinantes de /stream e /ws
+// Chamada pelo loop principal logo após cada leitura dos sensores
+void publicar_amostra_web(void) {
+    if (estatisticas_http.assinantes_sse == 0 && estatisticas_http.assinantes_ws == 0) return;
+
+    cyw43_arch_lwip_begin();                     // O loop principal roda fora do contexto do lwIP
+    difundir_amostra();
+    cyw43_arch_lwip_end();
+}
+
+/* =================== PERSISTÊNCIA DA CONFIGURAÇÃO =================== */
+// Restaura a configuração gravada mais recente (uma varredura da área de registros)
+// Sem registro, ou com valores que não passam na validação, valem os padrões da tabela
+void restaurar_configuracao(void) {
+    registro_iniciar();
+
+    uint16_t tamanho;
+    const uint8_t *dados = registro_ler(REGISTRO_CHAVE_CONFIG, &tamanho);
+    if (!dados) {
+        printf("Configuração: padrões (nada gravado na flash)\n");
+        return;
+    }
+    configuracao_t salva = config_atual;
+    uint32_t versao;
+    erro_config_t erro;
+    if (!config_desserializar(&salva, &versao, dados, tamanho) || !config_validar(&salva, &erro)) {
+        printf("Configuração gravada inválida; usando padrões\n");
+        return;
+    }
+    config_restaurar(&salva, versao);
+    printf("Configuração restaurada da flash (versão %lu, varredura em %lu us)\n",
+           (unsigned long)versao, (unsigned long)estatisticas_registro.varredura_us);
+}
+
+// Grava a configuração em vigor depois de ATRASO_GRAVACAO_CONFIG_MS sem alterações,
+// para que uma sequência de ajustes vire um só registro na flash
+// Roda no loop principal: a flash não pode ser gravada de dentro dos callbacks do lwIP
+void salvar_configuracao_pendente(void) {
+    if (!config_nao_salva) return;
+    uint32_t agora = to_ms_since_boot(get_absolute_time());
+    if (agora - instante_alteracao_config < ATRASO_GRAVACAO_CONFIG_MS) return;
+
+    // Copia a configuração sem que uma alteração chegue no meio
+    uint8_t dados[CONFIG_TAM_SERIALIZADA];
+    cyw43_arch_lwip_begin();
+    size_t tamanho = config_serializar(&config_atual, versao_config, dados, sizeof(dados));
+    config_nao_salva = false;
+    cyw43_arch_lwip_end();
+
+    if (!registro_gravar(REGISTRO_CHAVE_CONFIG, dados, (uint16_t)tamanho)) {
+        // Tenta de novo depois de outro ATRASO_GRAVACAO_CONFIG_MS
+        printf("Falha ao gravar a configuração na flash\n");
+        instante_alteracao_config = agora;
+        config_nao_salva = true;
+        return;
+    }
+    printf("Configuração gravada (bloqueio do XIP: %lu us)\n",
+           (unsigned long)estatisticas_registro.ultimo_bloqueio_us);
+}
+
 /* =================== FUNÇÕES DE LÓGICA DE ESTADOS =================== */
 // Analisa valores atuais dos sensores e determina o estado do sistema
 // Esta função implementa a lógica de decisão para alertas
+// Leituras e limites estão em centésimos (a pressão em Pa, os limites em centésimos de hPa)
+// Roda no loop principal: compara com uma cópia dos limites, nunca com metade de uma alteração
 EstadoSistema verificar_estado_atual(void) {
-    float pressao_hpa = pressao_atual / 100.0f; // Converte pressão de Pa para hPa
-    
+    configuracao_t config;
+    config_copiar(&config);
     // Verifica condições em ordem de prioridade
     // Temperatura tem prioridade sobre outros parâmetros
-    if (temp_media > limite_temp_max) return ESTADO_TEMP_ALTA;
-    if (temp_media < limite_temp_min) return ESTADO_TEMP_BAIXA;
+    if (temp_media > config.temp_max) return ESTADO_TEMP_ALTA;
+    if (temp_media < config.temp_min) return ESTADO_TEMP_BAIXA;
     // Depois verifica umidade
-    if (umidade_atual > limite_umid_max) return ESTADO_UMID_ALTA;
-    if (umidade_atual < limite_umid_min) return ESTADO_UMID_BAIXA;
+    if (umidade_atual > config.umid_max) return ESTADO_UMID_ALTA;
+    if (umidade_atual < config.umid_min) return ESTADO_UMID_BAIXA;
     // Por último verifica pressão
-    if (pressao_hpa > limite_press_max) return ESTADO_PRESS_ALTA;
-    if (pressao_hpa < limite_press_min) return ESTADO_PRESS_BAIXA;
+    if (pressao_atual > config.press_max) return ESTADO_PRESS_ALTA;
+    if (pressao_atual < config.press_min) return ESTADO_PRESS_BAIXA;
     // Se chegou aqui, todos os valores estão dentro dos limites
     return ESTADO_NORMAL;
 }
@@ -411,17 +1805,16 @@ void atualizar_indicadores_led(EstadoSistema estado) {
 }
 
 // Configura frequência do buzzer através do módulo PWM
-// Calcula divisores e períodos necessários para gerar a frequência desejada
-void definir_frequencia_buzzer(uint slice_num, float freq) {
+// Calcula divisores e períodos necessários para gerar a frequência desejada (em Hz)
+void definir_frequencia_buzzer(uint slice_num, uint32_t freq) {
     uint32_t clock = 125000000;      // Clock do sistema = 125MHz
-    uint32_t f_int = (uint32_t)freq;   // Frequência desejada convertida para inteiro
-    if (f_int == 0) return;            // Se frequência é zero, não faz nada
+    if (freq == 0) return;             // Se frequência é zero, não faz nada
     
     // Cálcula divisor necessário para atingir a frequência
     // Formula complexa para trabalhar com limitações do hardware PWM
-    uint32_t divisor16 = clock / f_int / 4096 + (clock % (f_int * 4096) != 0);
+    uint32_t divisor16 = clock / freq / 4096 + (clock % (freq * 4096) != 0);
     if (divisor16 / 16 == 0) divisor16 = 16;     // Valor mínimo
-    uint32_t wrap = (uint32_t)(clock * 16.0f / divisor16 / freq) - 1;
+    uint32_t wrap = clock * 16u / divisor16 / freq - 1;   // 2e9 ainda cabe em 32 bits
     
     // Configura módulo PWM com valores calculados
     pwm_set_clkdiv_int_frac(slice_num, divisor16 / 16, divisor16 & 0xF);
@@ -488,16 +1881,17 @@ int main() {
     
     // Declara estruturas principais do sistema
     ssd1306_t display;                   // Estrutura para controle do display OLED
-    struct bmp280_calib_param params_bmp;    // Parâmetros de calibração do sensor BMP280
-    uint64_t proxima_coleta = 0;           // Timestamp da próxima leitura dos sensores
     
     // Inicializa todos os periféricos do sistema
-    inicializar_hardware_completo(&display, &params_bmp);
+    config_iniciar();                // Seção crítica da configuração em vigor
+    restaurar_configuracao();        // Limites e calibrações gravados na flash
+    inicializar_hardware_completo(&display, &calibracao_bmp280);
     configurar_botoes_navegacao();   // Configura botões com interrupções
     configurar_joystick_zoom();      // Configura ADC para joystick
     configurar_leds_status();        // Configura LEDs RGB como saída
     configurar_buzzer_alertas();     // Configura PWM para buzzer
     inicializar_conexao_wifi(&display); // Conecta no WiFi e inicia servidor web
+    multicore_launch_core1(nucleo1_aquisicao); // Leitura dos sensores a partir daqui só no núcleo 1
     
     // Loop principal infinito
     while (true) {
@@ -506,31 +1900,16 @@ int main() {
             cyw43_arch_poll(); // Chama rotinas da pilha TCP/IP
         }
         
-        // Verifica se é hora de coletar dados dos sensores (a cada 2 segundos)
-        if (time_us_64() >= proxima_coleta) {
-            // Lê dados de todos os sensores
-            coletar_dados_todos_sensores(&params_bmp, &temp_aht, &temp_bmp, &temp_media, &umidade_atual, &pressao_atual);
-            proxima_coleta = time_us_64() + INTERVALO_LEITURA_MS * 1000; // Agenda próxima leitura
-            
-            // Atualiza buffer circular para gráficos (mantém últimos 30 pontos)
-            historico_temp[indice_circular] = temp_media;
-            historico_umid[indice_circular] = umidade_atual;
-            historico_press[indice_circular] = pressao_atual / 100.0f; // Converte Pa para hPa
-            indice_circular = (indice_circular + 1) % TAMANHO_BUFFER_GRAFICO; // Avança índice circular
-            if (contador_amostras < TAMANHO_BUFFER_GRAFICO) contador_amostras++; // Conta até encher buffer
-            
-            // Atualiza buffer maior para interface web (mantém últimos 100 pontos)
-            dados_web_temp[indice_web] = temp_media;
-            dados_web_umid[indice_web] = umidade_atual;
-            dados_web_press[indice_web] = pressao_atual / 100.0f;
-            indice_web = (indice_web + 1) % TAMANHO_HISTORICO_WEB; // Avança índice web
-            if (contador_web < TAMANHO_HISTORICO_WEB) contador_web++; // Conta até encher buffer web
-            
-            // Analisa estado atual e atualiza indicadores
+        // Amostras publicadas pelo núcleo 1 desde a última volta (normalmente nenhuma ou uma)
+        amostra_sensores_t amostra;
+        while (fila_amostras_consumir(&fila_amostras, &amostra)) {
+            processar_amostra(&amostra);
+        }
+        // Limites alterados pela interface web valem sem esperar a próxima amostra
+        if (reavaliar_alertas) {
+            reavaliar_alertas = false;
             estado_atual = verificar_estado_atual();
             atualizar_indicadores_led(estado_atual);
-            // Se está em tela que mostra dados, marca para atualizar display
-            if (tela_ativa >= TELA_DADOS_SENSORES) flag_atualizar_display = true;
         }
         
         // Atualiza matriz de LEDs com animação baseada no estado
@@ -546,6 +1925,8 @@ int main() {
         
         // Processa joystick para zoom nos gráficos
         processar_movimento_joystick();
+        // Grava na flash a configuração alterada pela interface web
+        salvar_configuracao_pendente();
         sleep_ms(10); // Pausa curta para não sobrecarregar CPU
     }
     return 0; // Nunca deveria chegar aqui
@@ -554,24 +1935,32 @@ int main() {
 /* =================== INICIALIZAÇÃO DO HARDWARE =================== */
 // Inicializa todos os periféricos necessários
 void inicializar_hardware_completo(ssd1306_t *display, struct bmp280_calib_param *params) {
-    // Configura barramento I2C para sensores (velocidade 100kHz)
-    i2c_init(I2C_SENSORES_PORT, 100 * 1000);
+    // Configura barramento I2C para sensores, com transações por DMA: 400kHz é o limite
+    // da placa, e a frequência final é a maior que os dispositivos registrados aceitam
+    barramento_iniciar(I2C_SENSORES_PORT, 400 * 1000);
     gpio_set_function(I2C_SENSORES_SDA_PIN, GPIO_FUNC_I2C); // Configura pino como SDA
     gpio_set_function(I2C_SENSORES_SCL_PIN, GPIO_FUNC_I2C); // Configura pino como SCL
     gpio_pull_up(I2C_SENSORES_SDA_PIN);                     // Ativa resistor pull-up interno
     gpio_pull_up(I2C_SENSORES_SCL_PIN);                     // Pull-up necessário para I2C
     // Configura barramento I2C para display (velocidade 400kHz - mais rápido)
-    i2c_init(I2C_DISPLAY_PORT, 400 * 1000);
+    // Um quadro inteiro (1025 bytes, ~25 ms) sai por DMA sem prender o loop
+    barramento_iniciar(I2C_DISPLAY_PORT, 400 * 1000);
     gpio_set_function(I2C_DISPLAY_SDA_PIN, GPIO_FUNC_I2C);
     gpio_set_function(I2C_DISPLAY_SCL_PIN, GPIO_FUNC_I2C);
     gpio_pull_up(I2C_DISPLAY_SDA_PIN);
     gpio_pull_up(I2C_DISPLAY_SCL_PIN);
+    // Dispositivos de cada barramento: estatísticas, prioridade e frequência máxima
+    // O BMP280 vem antes: sua leitura é curta e deve sair no mesmo ciclo de conversão
+    barramento_registrar(I2C_SENSORES_PORT, AHT20_I2C_ADDR, "aht20", AHT20_I2C_FREQ_MAX, PRIORIDADE_NORMAL, 0);
+    barramento_registrar(I2C_SENSORES_PORT, ADDR, "bmp280", BMP280_I2C_FREQ_MAX, PRIORIDADE_ALTA,
+                         DISPOSITIVO_AUTO_INCREMENTO);
+    barramento_registrar(I2C_DISPLAY_PORT, ENDERECO_DISPLAY, "ssd1306", SSD1306_I2C_FREQ_MAX, PRIORIDADE_NORMAL, 0);
     // Inicializa display OLED (SSD1306)
     ssd1306_init(display, LARGURA_DISPLAY, ALTURA_DISPLAY, false, ENDERECO_DISPLAY, I2C_DISPLAY_PORT);
     ssd1306_config(display); // Aplica configurações padrão
     // Inicializa sensores
     aht20_init(I2C_SENSORES_PORT);                 // Inicializa sensor temperatura/umidade
-    bmp280_init(I2C_SENSORES_PORT);                // Inicializa sensor pressão/temperatura
+    configurar_bmp280(&config_atual);              // Inicializa sensor pressão/temperatura (modo normal)
     bmp280_get_calib_params(I2C_SENSORES_PORT, params); // Lê parâmetros de calibração do BMP280
 }
 
@@ -707,19 +2096,19 @@ void processar_movimento_joystick(void) {
     bool mudou_zoom = false;
     
     // Determina qual variável de zoom alterar baseado na tela ativa
-    // CORREÇÃO: O ponteiro agora é 'volatile float *' para corresponder ao tipo das variáveis de zoom.
-    volatile float *fator_zoom_atual = (tela_ativa == TELA_GRAFICO_TEMP) ? &fator_zoom_temp : 
-                                     (tela_ativa == TELA_GRAFICO_UMIDADE) ? &fator_zoom_umid : &fator_zoom_press;
+    // O ponteiro é 'volatile uint8_t *' para corresponder ao tipo das variáveis de zoom
+    volatile uint8_t *fator_zoom_atual = (tela_ativa == TELA_GRAFICO_TEMP) ? &fator_zoom_temp : 
+                                       (tela_ativa == TELA_GRAFICO_UMIDADE) ? &fator_zoom_umid : &fator_zoom_press;
     
-    // Verifica direção do joystick e altera zoom
-    if (valor_adc > ZONA_MORTA_MAX && *fator_zoom_atual < 4.0f) {
+    // Verifica direção do joystick e altera zoom (em passos de 0,1x)
+    if (valor_adc > ZONA_MORTA_MAX && *fator_zoom_atual < 40) {
         // Joystick para cima = aumenta zoom (máximo 4x)
-        *fator_zoom_atual += 0.10f;
+        *fator_zoom_atual += 1;
         mudou_zoom = true;
     }
-    else if (valor_adc < ZONA_MORTA_MIN && *fator_zoom_atual > 0.25f) {
-        // Joystick para baixo = diminui zoom (mínimo 0.25x)
-        *fator_zoom_atual -= 0.10f;
+    else if (valor_adc < ZONA_MORTA_MIN && *fator_zoom_atual > 2) {
+        // Joystick para baixo = diminui zoom (mínimo 0,2x)
+        *fator_zoom_atual -= 1;
         mudou_zoom = true;
     }
     // Se houve mudança, atualiza display
@@ -744,28 +2133,33 @@ void exibir_tela_inicial(ssd1306_t *display) {
     ssd1306_send_data(display); // Envia dados para o display
 }
 
-// Exibe valores atuais de todos os sensores
-void exibir_dados_sensores(ssd1306_t *display, float t_aht, float t_bmp, float t_med, float umid, float press) {
+// Exibe valores atuais de todos os sensores (em centésimos, com uma casa na tela)
+void exibir_dados_sensores(ssd1306_t *display, int32_t t_aht, int32_t t_bmp, int32_t t_med, int32_t umid, int32_t press) {
     ssd1306_fill(display, 0);
     // Cabeçalho centralizado
     const char *titulo = "Dados Coletados";
     ssd1306_draw_string(display, titulo, (LARGURA_DISPLAY - strlen(titulo) * 8) / 2, 0, false);
-    // Buffer para formatação de strings
-    char buffer[32];
+    // Buffers para formatação de strings
+    char buffer[32], numero[12];
     // Temperatura do AHT20
-    snprintf(buffer, sizeof(buffer), "AHT20: %.1fC", t_aht);
+    centesimos_formatar(numero, sizeof(numero), t_aht, 1);
+    snprintf(buffer, sizeof(buffer), "AHT20: %sC", numero);
     ssd1306_draw_string(display, buffer, 0, 12, false);
     // Temperatura do BMP280  
-    snprintf(buffer, sizeof(buffer), "BMP280:%.1fC", t_bmp);
+    centesimos_formatar(numero, sizeof(numero), t_bmp, 1);
+    snprintf(buffer, sizeof(buffer), "BMP280:%sC", numero);
     ssd1306_draw_string(display, buffer, 0, 22, false);
     // Temperatura média
-    snprintf(buffer, sizeof(buffer), "Media: %.1fC", t_med);
+    centesimos_formatar(numero, sizeof(numero), t_med, 1);
+    snprintf(buffer, sizeof(buffer), "Media: %sC", numero);
     ssd1306_draw_string(display, buffer, 0, 32, false);
     // Umidade
-    snprintf(buffer, sizeof(buffer), "Umidade:%.1f%%", umid);
+    centesimos_formatar(numero, sizeof(numero), umid, 1);
+    snprintf(buffer, sizeof(buffer), "Umidade:%s%%", numero);
     ssd1306_draw_string(display, buffer, 0, 42, false);
-    // Pressão (convertida de Pa para hPa)
-    snprintf(buffer, sizeof(buffer), "Press:%.1fhPa", press / 100.0);
+    // Pressão (Pa já é centésimos de hPa)
+    centesimos_formatar(numero, sizeof(numero), press, 1);
+    snprintf(buffer, sizeof(buffer), "Press:%shPa", numero);
     ssd1306_draw_string(display, buffer, 0, 52, false);
     
     ssd1306_send_data(display);
@@ -783,18 +2177,19 @@ void exibir_status_conexao(ssd1306_t *display) {
     // Status WiFi
     snprintf(buffer, sizeof(buffer), "WiFi:%s", wifi_conectado ? "OK" : "FALHA");
     ssd1306_draw_string(display, buffer, 0, 22, false);
-    // Analisa e exibe status de cada parâmetro
-    const char *status_temp = (temp_media < limite_temp_min) ? "Baixa" : 
-                              (temp_media > limite_temp_max) ? "Alta" : "OK";
+    // Analisa e exibe status de cada parâmetro (com uma cópia dos limites)
+    configuracao_t config;
+    config_copiar(&config);
+    const char *status_temp = (temp_media < config.temp_min) ? "Baixa" : 
+                              (temp_media > config.temp_max) ? "Alta" : "OK";
     snprintf(buffer, sizeof(buffer), "Temp:%s", status_temp);
     ssd1306_draw_string(display, buffer, 0, 32, false);
-    const char *status_umid = (umidade_atual < limite_umid_min) ? "Baixa" : 
-                              (umidade_atual > limite_umid_max) ? "Alta" : "OK";
+    const char *status_umid = (umidade_atual < config.umid_min) ? "Baixa" : 
+                              (umidade_atual > config.umid_max) ? "Alta" : "OK";
     snprintf(buffer, sizeof(buffer), "Umid:%s", status_umid);
     ssd1306_draw_string(display, buffer, 0, 42, false);
-    float pressao_hpa = pressao_atual / 100.0f;
-    const char *status_press = (pressao_hpa < limite_press_min) ? "Baixa" : 
-                               (pressao_hpa > limite_press_max) ? "Alta" : "OK";
+    const char *status_press = (pressao_atual < config.press_min) ? "Baixa" : 
+                               (pressao_atual > config.press_max) ? "Alta" : "OK";
     snprintf(buffer, sizeof(buffer), "Press:%s", status_press);
     ssd1306_draw_string(display, buffer, 0, 52, false);
     ssd1306_send_data(display);
@@ -816,9 +2211,34 @@ void exibir_status_led_rgb(ssd1306_t *display) {
     ssd1306_send_data(display);
 }
 
+// Estado do traçado de um gráfico no display, ponto a ponto
+struct contexto_grafico {
+    ssd1306_t *display;
+    uint8_t area_x, area_y, altura, largura;
+    int32_t y_min, faixa;            // Em centésimos; faixa > 0
+    bool tem_anterior;               // Já há um ponto para ligar ao próximo
+    uint8_t x_anterior, y_anterior;
+};
+
+// Converte o ponto para pixels e o liga ao ponto anterior
+// Com zoom, um ponto fora da faixa fica na borda da área do gráfico
+static void desenhar_ponto_grafico(uint16_t indice, int32_t valor, void *contexto) {
+    struct contexto_grafico *g = contexto;
+    uint8_t x = g->area_x + (indice * g->largura) / (TAMANHO_BUFFER_GRAFICO - 1);
+    // Diferença de no máximo alguns milhares de hPa em centésimos, vezes a altura: cabe em 32 bits
+    int32_t altura = (valor - g->y_min) * g->altura / g->faixa;
+    if (altura < 0) altura = 0;
+    if (altura > g->altura) altura = g->altura;
+    uint8_t y = g->area_y - (uint8_t)altura;
+    if (g->tem_anterior) ssd1306_line(g->display, g->x_anterior, g->y_anterior, x, y, true);
+    g->tem_anterior = true;
+    g->x_anterior = x;
+    g->y_anterior = y;
+}
+
 // Função genérica para desenhar qualquer gráfico com zoom
-// Recebe array de dados, fator de zoom e unidade de medida
-void desenhar_grafico_base(ssd1306_t *display, const char *titulo, float *buffer_dados, float fator_zoom, const char *unidade) {
+// Recebe array de dados (em centésimos), fator de zoom (em décimos) e unidade de medida
+void desenhar_grafico_base(ssd1306_t *display, const char *titulo, const int32_t *buffer_dados, uint8_t fator_zoom, const char *unidade) {
     ssd1306_fill(display, 0);
     // Define área do gráfico na tela
     const uint8_t area_x = 20, area_y = 52, altura = 40, largura = 105;
@@ -832,43 +2252,38 @@ void desenhar_grafico_base(ssd1306_t *display, const char *titulo, float *buffer
     }
     
     // Encontra valores mínimo e máximo no buffer para escalar gráfico
-    float val_min = buffer_dados[0], val_max = val_min;
+    int32_t val_min = buffer_dados[0], val_max = val_min;
     for (int i = 0; i < contador_amostras; ++i) {
         int idx = (indice_circular - contador_amostras + i + TAMANHO_BUFFER_GRAFICO) % TAMANHO_BUFFER_GRAFICO;
-        float val = buffer_dados[idx];
+        int32_t val = buffer_dados[idx];
         if (val < val_min) val_min = val;
         if (val > val_max) val_max = val;
     }
     
-    // Garante faixa mínima para evitar divisão por zero
-    if (val_max - val_min < 2.0f) {
-        float media = (val_max + val_min) / 2.0f;
-        val_min = media - 1.0f;
-        val_max = media + 1.0f;
+    // Garante faixa mínima (2 unidades) para evitar divisão por zero
+    if (val_max - val_min < 2 * CENTESIMOS) {
+        int32_t media = (val_max + val_min) / 2;
+        val_min = media - CENTESIMOS;
+        val_max = media + CENTESIMOS;
     }
     
     // Aplica zoom centralizando na média dos valores
-    float faixa_zoom = (val_max - val_min) / fator_zoom;
-    float centro = (val_max + val_min) * 0.5f;
-    float y_min = centro - faixa_zoom * 0.5f;
-    float y_max = centro + faixa_zoom * 0.5f;
+    int32_t faixa_zoom = (val_max - val_min) * 10 / fator_zoom;
+    int32_t y_min = (val_max + val_min) / 2 - faixa_zoom / 2;
     
     // Desenha eixos do gráfico
     ssd1306_hline(display, area_x, area_x + largura, area_y, true);     // Eixo X
     ssd1306_vline(display, area_x, area_y - altura, area_y, true);      // Eixo Y
     
     // Marcações no eixo Y (3 divisões)
-    float passo = faixa_zoom / 3.0f;
-    if (passo < 0.1f) passo = 0.1f; // Passo mínimo
-    
     for (int i = 0; i <= 3; i++) {
-        float valor_marca = y_min + (i * faixa_zoom / 3.0f);
+        int32_t valor_marca = y_min + i * faixa_zoom / 3;
         uint8_t y_pos = area_y - (i * altura / 3);
         // Desenha tick mark
         ssd1306_hline(display, area_x - 2, area_x, y_pos, true);
-        // Label numérico
+        // Label numérico, em unidades inteiras
         char marca[8];
-        snprintf(marca, sizeof(marca), "%.0f", valor_marca);
+        centesimos_formatar(marca, sizeof(marca), valor_marca, 0);
         ssd1306_draw_string(display, marca, 0, y_pos - 4, false);
     }
     // Marcações no eixo X (tempo: 0, 30s, 60s)
@@ -879,25 +2294,13 @@ void desenhar_grafico_base(ssd1306_t *display, const char *titulo, float *buffer
     ssd1306_draw_string(display, "30s", area_x + largura/2 - 10, area_y + 5, false);
     ssd1306_draw_string(display, "60s", area_x + largura - 18, area_y + 5, false);
     
-    // Desenha linhas conectando pontos do gráfico
-    if (contador_amostras > 1) {
-        for (int i = 0; i < contador_amostras - 1; ++i) {
-            // Índices dos pontos atual e próximo no buffer circular
-            int idx1 = (indice_circular - contador_amostras + i + TAMANHO_BUFFER_GRAFICO) % TAMANHO_BUFFER_GRAFICO;
-            int idx2 = (idx1 + 1) % TAMANHO_BUFFER_GRAFICO;
-            
-            float val1 = buffer_dados[idx1], val2 = buffer_dados[idx2];
-            
-            // Converte valores para coordenadas de pixel
-            uint8_t x1 = area_x + (i * largura) / (TAMANHO_BUFFER_GRAFICO - 1);
-            uint8_t y1 = area_y - (uint8_t)(((val1 - y_min) / faixa_zoom) * altura);
-            uint8_t x2 = area_x + ((i + 1) * largura) / (TAMANHO_BUFFER_GRAFICO - 1);
-            uint8_t y2 = area_y - (uint8_t)(((val2 - y_min) / faixa_zoom) * altura);
-            
-            // Desenha linha entre os pontos
-            ssd1306_line(display, x1, y1, x2, y2, true);
-        }
-    }
+    // Desenha linhas conectando os pontos; com mais amostras que colunas,
+    // o LTTB escolhe no máximo um ponto por pixel mantendo picos e vales
+    struct contexto_grafico ctx = {display, area_x, area_y, altura, largura, y_min, faixa_zoom, false, 0, 0};
+    serie_circular_t serie = {buffer_dados, TAMANHO_BUFFER_GRAFICO,
+        (uint16_t)((indice_circular - contador_amostras + TAMANHO_BUFFER_GRAFICO) % TAMANHO_BUFFER_GRAFICO),
+        (uint16_t)contador_amostras};
+    lttb_reduzir(&serie, largura, desenhar_ponto_grafico, &ctx);
     
     ssd1306_send_data(display);
 }
@@ -915,7 +2318,7 @@ void exibir_grafico_pressao(ssd1306_t *display) {
 
 /* =================== CONTROLE PRINCIPAL DO DISPLAY =================== */
 // Função principal que decide qual tela desenhar baseada na variável tela_ativa
-void atualizar_display_principal(ssd1306_t *display, float t_aht, float t_bmp, float t_med, float umid, float press) {
+void atualizar_display_principal(ssd1306_t *display, int32_t t_aht, int32_t t_bmp, int32_t t_med, int32_t umid, int32_t press) {
     switch (tela_ativa) {
         case TELA_INICIAL:          exibir_tela_inicial(display); break;
         case TELA_DADOS_SENSORES:   exibir_dados_sensores(display, t_aht, t_bmp, t_med, umid, press); break;
@@ -928,26 +2331,203 @@ void atualizar_display_principal(ssd1306_t *display, float t_aht, float t_bmp, f
 }
 
 /* =================== COLETA DE DADOS DOS SENSORES =================== */
-// Lê dados de todos os sensores e aplica calibrações
-void coletar_dados_todos_sensores(struct bmp280_calib_param *params, float *t_aht, float *t_bmp, float *t_med, float *umid, float *press) {
-    // Lê sensor AHT20 (temperatura + umidade)
+// Configuração já aplicada ao BMP280; zerada força a próxima escrita
+static struct bmp280_config config_bmp280_aplicada;
+
+// Aplica ao BMP280 a sobreamostragem, o filtro e a pausa de 'config', se mudaram
+// O sensor fica em modo normal, convertendo sozinho; a coleta só lê o último resultado
+// Chamada da inicialização e do núcleo 1, nunca dos callbacks do lwIP (que só alteram config_atual)
+void configurar_bmp280(const configuracao_t *config) {
+    struct bmp280_config desejada = {
+        .osrs_t = (uint8_t)config->bmp_osrs_t,
+        .osrs_p = (uint8_t)config->bmp_osrs_p,
+        .filter = (uint8_t)config->bmp_filtro,
+        .standby = (uint8_t)config->bmp_standby,
+    };
+    if (memcmp(&desejada, &config_bmp280_aplicada, sizeof(desejada)) == 0) return;
+    if (bmp280_configure(I2C_SENSORES_PORT, &desejada)) {
+        config_bmp280_aplicada = desejada;
+        printf("BMP280: novo resultado a cada %lu us\n", (unsigned long)bmp280_cycle_time_us(&desejada));
+    }
+}
+
+// Lê o último resultado do BMP280 (status e dados numa só rajada) e aplica as calibrações
+// As saídas sempre recebem os valores mais recentes, em centésimos de °C e em Pa;
+// retorna true só se esta leitura trouxe uma conversão nova (não repetida, e o sensor respondeu)
+bool ler_bmp280(const configuracao_t *config, struct bmp280_calib_param *params, int32_t *t_bmp, int32_t *press) {
+    static struct bmp280_reading leitura_bmp;
+    static int32_t bmp280_temp_bruta, bmp280_press_bruta;   // Compensadas, sem os ajustes da calibração
+    bool nova = false;
+    configurar_bmp280(config);
+    if (bmp280_read_burst(I2C_SENSORES_PORT, &leitura_bmp)) {
+        // Conversão repetida (pausa maior que o intervalo entre leituras) já está nas saídas
+        if (leitura_bmp.fresh) {
+            // Converte valores brutos usando parâmetros de calibração do sensor (t_fine calculado uma vez)
+            int32_t temp_conv, press_conv;
+            bmp280_compensate(leitura_bmp.temp, leitura_bmp.pressure, params, &temp_conv, &press_conv);
+
+            // A temperatura já vem em centésimos de °C; a pressão vem em Pa no Q24.8
+            bmp280_temp_bruta = temp_conv;
+            bmp280_press_bruta = (press_conv + (1 << (BMP280_PRESSURE_FRAC_BITS - 1))) >> BMP280_PRESSURE_FRAC_BITS;
+            nova = true;
+        }
+    } else {
+        // Sem resposta, ou sensor reiniciado (fora do modo normal): reconfigura na próxima
+        // leitura e mantém os últimos valores do BMP280
+        memset(&config_bmp280_aplicada, 0, sizeof(config_bmp280_aplicada));
+    }
+    *t_bmp = bmp280_temp_bruta + config->offset_temp_bmp;
+    *press = bmp280_press_bruta + config->offset_press;   // Centésimos de hPa = Pa
+    return nova;
+}
+
+// Lê dados de todos os sensores e aplica calibrações (no núcleo 1)
+// Feita em etapas para não travar quem chama: a primeira chamada dispara a
+// conversão do AHT20 (~80 ms) e retorna false; as seguintes só conferem se ela
+// terminou. Retorna true quando a amostra completa está nas variáveis de saída (em centésimos);
+// 'bmp_nova' diz se a leitura do BMP280 feita nela trouxe uma conversão nova
+bool coletar_dados_todos_sensores(const configuracao_t *config, struct bmp280_calib_param *params, int32_t *t_aht, int32_t *t_bmp, int32_t *t_med, int32_t *umid, int32_t *press, bool *bmp_nova) {
+    static AHT20_Measurement medicao_aht;
+    if (!medicao_aht.active) {
+        // Sem resposta do AHT20: segue só com o BMP280, mantendo os últimos valores do AHT20
+        if (aht20_start_measurement(I2C_SENSORES_PORT, &medicao_aht)) return false;
+    }
+
+    // Lê sensor AHT20 (temperatura + umidade), se a conversão já terminou
     AHT20_Data dados_aht;
-    aht20_read(I2C_SENSORES_PORT, &dados_aht);
-    *t_aht = dados_aht.temperature + ajuste_temp_aht; // Aplica calibração
-    *umid = dados_aht.humidity + ajuste_umidade;      // Aplica calibração
+    AHT20_Status status_aht = aht20_poll_result(I2C_SENSORES_PORT, &medicao_aht, &dados_aht);
+    if (status_aht == AHT20_PENDING) return false;
+    if (status_aht == AHT20_READY) {
+        *t_aht = dados_aht.temperature + config->offset_temp_aht; // Aplica calibração
+        *umid = dados_aht.humidity + config->offset_umid;         // Aplica calibração
+    }
     
     // Lê sensor BMP280 (temperatura + pressão)
-    int32_t temp_raw, press_raw;
-    bmp280_read_raw(I2C_SENSORES_PORT, &temp_raw, &press_raw); // Lê valores brutos
-    
-    // Converte valores brutos usando parâmetros de calibração do sensor
-    int32_t temp_conv = bmp280_convert_temp(temp_raw, params);
-    int32_t press_conv = bmp280_convert_pressure(press_raw, temp_raw, params);
-    
-    // Converte para float e aplica calibrações
-    *t_bmp = (temp_conv / 100.0f) + ajuste_temp_bmp;       // BMP280 retorna temp * 100
-    *press = press_conv + (ajuste_pressao * 100.0f);      // Pressão em Pa, ajuste em hPa
+    *bmp_nova = ler_bmp280(config, params, t_bmp, press);
     
     // Calcula temperatura média dos dois sensores
-    *t_med = (*t_aht + *t_bmp) / 2.0f;
-}
\ No newline at end of file
+    *t_med = (*t_aht + *t_bmp) / 2;
+    return true;
+}
+
+// Laço do núcleo 1: coleta numa cadência fixa e publica cada amostra na fila
+// Entre as coletas, lê o BMP280 a taxa_bmp_hz e resume as leituras novas do
+// intervalo em mínimo, máximo e média: um pico curto aparece no máximo (ou no
+// mínimo) sem que a rede ou o histórico recebam mais amostras
+// Um sensor que falha mantém seus últimos valores, como antes
+// A configuração é copiada uma vez por coleta: todas as leituras de um intervalo
+// usam os mesmos ajustes, e uma alteração vale a partir da coleta seguinte
+void nucleo1_aquisicao(void) {
+    flash_safe_execute_core_init();   // O núcleo 0 pode pausar este enquanto grava na flash
+    int32_t t_aht = 0, t_bmp = 0, t_med = 0, umid = 0, press = 0;   // Centésimos
+    configuracao_t config;
+    config_copiar(&config);
+    uint32_t sequencia = 0;
+    uint64_t agenda = time_us_64();
+    uint64_t proxima_rapida = agenda;
+    bool coletando = false;
+    agregado_t agregado_temp, agregado_press;
+    agregado_zerar(&agregado_temp);
+    agregado_zerar(&agregado_press);
+
+    while (true) {
+        uint64_t agora = time_us_64();
+        int32_t taxa = config.taxa_bmp_hz;
+        if (taxa > 0 && agora >= proxima_rapida) {
+            uint64_t periodo = 1000000u / (uint32_t)taxa;
+            proxima_rapida = proxima_rapida + periodo > agora ? proxima_rapida + periodo : agora + periodo;
+            int32_t t, p;
+            if (ler_bmp280(&config, &calibracao_bmp280, &t, &p)) {
+                agregado_incluir(&agregado_temp, t);
+                agregado_incluir(&agregado_press, p);
+            }
+        }
+        if (!coletando && agora >= agenda) {
+            uint32_t atraso = (uint32_t)(agora - agenda);
+            if (atraso > pior_atraso_coleta_us) pior_atraso_coleta_us = atraso;
+            coletando = true;
+        }
+        bool bmp_nova;
+        if (coletando && coletar_dados_todos_sensores(&config, &calibracao_bmp280, &t_aht, &t_bmp, &t_med, &umid, &press, &bmp_nova)) {
+            coletando = false;
+            // Uma conversão nova lida pela coleta entra no resumo como as rápidas (senão a
+            // próxima leitura rápida a veria como repetida e ela se perderia); sem nenhuma
+            // conversão nova no intervalo, o resumo é a leitura da coleta
+            if (bmp_nova || agregado_temp.contagem == 0) {
+                agregado_incluir(&agregado_temp, t_bmp);
+                agregado_incluir(&agregado_press, press);
+            }
+            t_bmp = agregado_media(&agregado_temp);
+            press = agregado_media(&agregado_press);
+            t_med = (t_aht + t_bmp) / 2;
+            amostra_sensores_t amostra = {
+                .instante_us = time_us_64(),
+                .sequencia = ++sequencia,
+                .temp_aht = t_aht,
+                .temp_bmp = t_bmp,
+                .temp_media = t_med,
+                .umidade = umid,
+                .pressao = press,
+                .agregado_temp_bmp = agregado_temp,
+                .agregado_pressao = agregado_press,
+            };
+            fila_amostras_publicar(&fila_amostras, &amostra);
+            amostras_coletadas++;
+            agregado_zerar(&agregado_temp);
+            agregado_zerar(&agregado_press);
+            config_copiar(&config);                  // Configuração do próximo intervalo
+
+            // Próxima coleta conta da agenda, não do fim desta (sem deriva);
+            // se atrasou mais de um intervalo inteiro, recomeça de agora
+            agenda += INTERVALO_LEITURA_MS * 1000ull;
+            if (agenda < time_us_64()) agenda = time_us_64();
+        }
+        sleep_ms(1);
+    }
+}
+
+// Registra no núcleo 0 uma amostra vinda do núcleo 1: leituras atuais, históricos,
+// clientes web, estado dos alertas e display
+void processar_amostra(const amostra_sensores_t *amostra) {
+    // Leituras atuais, anel web e sequência mudam juntos sob a trava do lwIP:
+    // /dados, /stream, /ws e /historico rodam nos callbacks do lwIP e não podem
+    // ver parte da amostra nova com o cache ou a sequência da anterior
+    if (wifi_conectado) cyw43_arch_lwip_begin();
+    temp_aht = amostra->temp_aht;
+    temp_bmp = amostra->temp_bmp;
+    temp_media = amostra->temp_media;
+    umidade_atual = amostra->umidade;
+    pressao_atual = amostra->pressao;
+    agregado_temp_bmp = amostra->agregado_temp_bmp;
+    agregado_pressao = amostra->agregado_pressao;
+
+    // Atualiza buffer maior para interface web (mantém últimos 100 pontos)
+    dados_web_temp[indice_web] = temp_media;
+    dados_web_umid[indice_web] = umidade_atual;
+    dados_web_press[indice_web] = pressao_atual;
+    // A faixa da temperatura é a da média: o AHT20 é lido uma vez por intervalo
+    dados_web_temp_faixa_min[indice_web] = (temp_aht + agregado_temp_bmp.minimo) / 2;
+    dados_web_temp_faixa_max[indice_web] = (temp_aht + agregado_temp_bmp.maximo) / 2;
+    dados_web_press_faixa_min[indice_web] = agregado_pressao.minimo;
+    dados_web_press_faixa_max[indice_web] = agregado_pressao.maximo;
+    indice_web = (indice_web + 1) % TAMANHO_HISTORICO_WEB; // Avança índice web
+    if (contador_web < TAMANHO_HISTORICO_WEB) contador_web++; // Conta até encher buffer web
+    sequencia_web++;                            // Número da amostra em /historico
+    invalidar_cache_dados();                    // /dados passa a refletir a nova leitura
+    if (wifi_conectado) cyw43_arch_lwip_end();
+
+    // Atualiza buffer circular para gráficos (mantém últimos 30 pontos)
+    historico_temp[indice_circular] = temp_media;
+    historico_umid[indice_circular] = umidade_atual;
+    historico_press[indice_circular] = pressao_atual;     // Pa: centésimos de hPa, como no gráfico
+    indice_circular = (indice_circular + 1) % TAMANHO_BUFFER_GRAFICO; // Avança índice circular
+    if (contador_amostras < TAMANHO_BUFFER_GRAFICO) contador_amostras++; // Conta até encher buffer
+
+    if (wifi_conectado) publicar_amostra_web(); // Empurra a amostra para os clientes em /stream e /ws
+    
+    // Analisa estado atual e atualiza indicadores
+    estado_atual = verificar_estado_atual();
+    atualizar_indicadores_led(estado_atual);
+    // Se está em tela que mostra dados, marca para atualizar display
+    if (tela_ativa >= TELA_DADOS_SENSORES) flag_atualizar_display = true;
+}
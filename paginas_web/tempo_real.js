@@ -0,0 +1,76 @@
+    // Canal com o servidor: recebe cada nova amostra e envia alterações de configuração
+    // Usa uma única conexão WebSocket em /ws; sem WebSocket, as amostras vêm do
+    // fluxo de eventos em /stream (ou de consultas a /dados) e as alterações vão por POST /config
+    // Uma conexão que fecha sem ter aberto (servidor cheio, proxy sem Upgrade) também
+    // passa para /stream: só uma conexão que já funcionou é refeita
+    function abrirCanal(callback, intervaloMs) {
+    const respostas = [];
+    let ws = null;
+    const conectar = () => {
+    let aberto = false;
+    ws = new WebSocket('ws://' + location.host + '/ws');
+    ws.onopen = () => { aberto = true; };
+    ws.onmessage = e => {
+    const msg = JSON.parse(e.data);
+    if ('comando' in msg) { const r = respostas.shift(); if (r) r(msg); }
+    else callback(msg);
+    };
+    ws.onclose = () => {
+    respostas.splice(0).forEach(r => r({ ok: false }));
+    if (aberto) setTimeout(conectar, 3000);
+    else { ws = null; receberDados(callback, intervaloMs); }
+    };
+    };
+    if (window.WebSocket) conectar();
+    else receberDados(callback, intervaloMs);
+    return {
+    // 'valores' só com os campos a alterar: { temp_min: 20, temp_max: 30 }
+    // A resposta traz ok, versao e, na falha, erro e campo
+    configurar(valores) {
+    const corpo = JSON.stringify(valores);
+    if (ws && ws.readyState === WebSocket.OPEN) {
+    return new Promise(r => { respostas.push(r); ws.send(corpo); });
+    }
+    return fetch('/config', { method: 'POST', headers: { 'Content-Type': 'application/json' }, body: corpo })
+    .then(res => res.json()).catch(() => ({ ok: false, erro: 'sem resposta' }));
+    }
+    };
+    }
+    // Recebe cada nova amostra do servidor pelo fluxo de eventos em /stream
+    // Navegadores sem EventSource consultam /dados periodicamente
+    function receberDados(callback, intervaloMs) {
+    if (window.EventSource) {
+    const fluxo = new EventSource('/stream');
+    fluxo.onmessage = e => callback(JSON.parse(e.data));
+    return;
+    }
+    const consultar = () => buscarDados().then(callback);
+    consultar();
+    setInterval(consultar, intervaloMs);
+    }
+    // Campos da telemetria binária, na ordem do formato (lib/Servidor_Bibliotecas/telemetria.h)
+    const CAMPOS_TELEMETRIA = ['temp_aht', 'temp_bmp', 'temp_media', 'umidade', 'pressao',
+    'temp_min', 'temp_max', 'umid_min', 'umid_max', 'press_min', 'press_max',
+    'offset_temp_aht', 'offset_temp_bmp', 'offset_umid', 'offset_press',
+    'intervalo.leituras', 'intervalo.temp_bmp_min', 'intervalo.temp_bmp_max',
+    'intervalo.pressao_min', 'intervalo.pressao_max'];
+    // Converte a telemetria binária (versão 1: 4 bytes de cabeçalho + float32 little-endian)
+    // no mesmo objeto que o JSON de /dados; campos além dos conhecidos são ignorados
+    // "intervalo.x" vai para o objeto aninhado, como no JSON
+    function decodificarTelemetria(buffer) {
+    const v = new DataView(buffer);
+    if (v.getUint8(0) < 1) throw new Error('telemetria inválida');
+    const n = Math.min(v.getUint8(1), CAMPOS_TELEMETRIA.length);
+    const dados = {};
+    for (let i = 0; i < n; i++) {
+    const [grupo, campo] = CAMPOS_TELEMETRIA[i].split('.');
+    const valor = v.getFloat32(4 + 4 * i, true);
+    if (campo) (dados[grupo] = dados[grupo] || {})[campo] = valor;
+    else dados[grupo] = valor;
+    }
+    return dados;
+    }
+    // Consulta a amostra atual em /dados no formato binário (84 bytes em vez de ~500)
+    function buscarDados() {
+    return fetch('/dados?fmt=bin').then(res => res.arrayBuffer()).then(decodificarTelemetria);
+    }